@@ -51,10 +51,27 @@ implementation of ~~FULL of~~ **Scheme** to C++.
 
 ## Usage
 
+``` bash
+meevax [OPTION]... [SCRIPT [ARGUMENT]...]
+```
+
+Without SCRIPT, meevax reads expressions from the standard input interactively.
+With SCRIPT, it evaluates the file without prompts and exits with failure status on error; `(command-line)` returns SCRIPT and the ARGUMENTs as a list of strings.
+
 | Option            | Description                           |
 |:------------------|:--------------------------------------|
 | `-v`, `--version` | Display version information and exit. |
 | `-h`, `--help`    | Display this help text and exit.      |
+| `--optimize`      | Fold constant expressions, remove dead branches and unused values, and inline lambda applications to constants and calls of small global procedures. |
+| `--workers=N`     | Use N threads for parallel primitives and futures (default: number of hardware threads). |
+| `--dump-image=FILE` | Write the heap booted with layer 1 to FILE and exit. |
+| `--image=FILE`    | Restore the heap from FILE instead of booting layer 1 from source (falls back to source if FILE is unusable). |
+| `--compile-cache` | Evaluate each loaded file from its compiled code cached by a previous load (or `compile-file`), and cache it otherwise. The cache is recompiled if the source, the build or `--optimize` changes, but not if macros the file uses are redefined. |
+| `--cache-directory=DIR` | Write the compiled code of loaded files to DIR instead of next to each file (as FILE.compiled). Implies `--compile-cache`. |
+| `--library-directory=DIR` | Load the library imported as (NAME ...) from DIR/NAME/....sld if it is not defined yet (default: the current directory). |
+| `--server=SOCKET`  | Boot, then listen on the Unix domain socket SOCKET and evaluate the standard input of each client in a forked copy of the booted interpreter. |
+| `--client=SOCKET`  | Evaluate the standard input on the server listening on SOCKET and exit with its status (`meevax-client SOCKET` does the same without loading the kernel). |
+| `--build-executable=FILE` | Compile SCRIPT, and write the standalone executable FILE which runs it. Only the definitions the program can reach are kept in its embedded image (the retained and pruned definitions and libraries are reported). Requires objcopy (or `$OBJCOPY`). |
 
 <br/>
 
@@ -116,6 +133,10 @@ cmake ..
 make
 ```
 
+The standard libraries are built as shared objects, and opened by the first
+application of their procedures. `cmake .. -DBUILTIN_LIBRARIES=ON` builds them
+into the kernel instead, so that no shared object is opened at run time.
+
 <br/>
 
 ## References
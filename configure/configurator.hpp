@@ -2,6 +2,7 @@
 #define INCLUDED_MEEVAX_KERNEL_CONFIGURATOR_HPP
 
 #include <regex>
+#include <sstream>
 #include <vector>
 
 #include <boost/cstdlib.hpp>
@@ -10,9 +11,6 @@
 #include <meevax/kernel/path.hpp>
 #include <meevax/kernel/reader.hpp>
 
-// XXX DIRTY HACK
-#include <meevax/posix/linker.hpp>
-
 namespace meevax::kernel
 {
   template <typename Environment>
@@ -58,26 +56,76 @@ namespace meevax::kernel
 
     static inline const auto install_prefix {make<path>("${CMAKE_INSTALL_PREFIX}")};
 
-    static inline object preloads {unit};
+    /* ==== Per-Instance Configurations ======================================
+    *
+    * Each syntactic_continuation owns its own copy of the following members,
+    * so that several interpreters (isolates) can run on separate OS threads
+    * without sharing any mutable state. Syntactic continuations constructed
+    * at runtime (macros) inherit them from their creator by "configure".
+    *
+    *======================================================================= */
+    object script_file {unit}; // evaluated instead of the interaction
+
+    object command_line {unit}; // list of strings returned by "command-line"
+
+    object debug               {false_object};
+    object experimental        {false_object};
+    object optimize            {false_object};
+    object trace               {false_object};
+    object variable            {unit};
+    object verbose             {false_object};
+    object verbose_compiler    {false_object};
+    object verbose_define      {false_object}; // TODO Rename to "verbose_syntax"
+    object verbose_environment {false_object};
+    object verbose_linker      {false_object};
+    object verbose_loader      {false_object};
+    object verbose_machine     {false_object};
+    object verbose_reader      {false_object};
+
+    object workers {unit}; // number of threads in thread pool (unit means hardware concurrency)
 
-    static inline auto debug               {false_object};
-    static inline auto experimental        {false_object};
-    static inline auto trace               {false_object};
-    static inline auto variable            {unit};
-    static inline auto verbose             {false_object};
-    static inline auto verbose_compiler    {false_object};
-    static inline auto verbose_define      {false_object}; // TODO Rename to "verbose_syntax"
-    static inline auto verbose_environment {false_object};
-    static inline auto verbose_loader      {false_object};
-    static inline auto verbose_machine     {false_object};
-    static inline auto verbose_reader      {false_object};
+    object image_file {unit}; // heap image to be restored instead of layer 1 (see image.hpp)
+    object dump_file  {unit}; // heap image to be written after layer 1 is booted
+
+    object compile_cache   {false_object}; // reuse compiled code of loaded files (see syntactic_continuation::load_file)
+    object cache_directory {unit}; // of compiled files (unit means next to the source)
+
+    object library_directory {unit}; // of library files (unit means the current directory)
+
+    object server_socket {unit}; // to be listened by the fork server (see posix/fork_server.hpp)
+    object client_socket {unit}; // of the fork server to evaluate the standard input
+
+    object executable_file {unit}; // standalone executable to be built of the script
+
+    /* ------------------------------------------------------------------------
+    * The trace of parsing the command line, written to the standard error
+    * after the parse only if "--verbose" or "--debug" is among the options.
+    *----------------------------------------------------------------------- */
+    std::stringstream parse_trace {};
+
+    #define PATHNAME(VARIABLE)                                                 \
+    [&](const auto& operands) mutable                                          \
+    {                                                                          \
+      if (not operands or not (operands.template is<string>() or               \
+                               operands.template is<symbol>()))                \
+      {                                                                        \
+        throw configuration_error {operands, " is not a pathname"};            \
+      }                                                                        \
+                                                                               \
+      parse_trace << ";\t\t; " << VARIABLE << " => ";                          \
+      VARIABLE = make<path>(operands.template is<string>()                     \
+                 ? static_cast<std::string>(operands.template as<string>())    \
+                 : operands.template as<const std::string>());                 \
+      parse_trace << VARIABLE << std::endl;                                    \
+      return VARIABLE;                                                         \
+    }
 
     #define ENABLE(VARIABLE)                                                   \
     [&](const auto&) mutable                                                   \
     {                                                                          \
-      std::cerr << ";\t\t; " << VARIABLE << " => ";                            \
+      parse_trace << ";\t\t; " << VARIABLE << " => ";                          \
       VARIABLE = true_object;                                                  \
-      std::cerr << VARIABLE << std::endl;                                      \
+      parse_trace << VARIABLE << std::endl;                                    \
       return VARIABLE;                                                         \
     }
 
@@ -117,10 +165,14 @@ namespace meevax::kernel
 
     const dispatcher<std::string> long_options_requires_no_operands
     {
+      std::make_pair("compile-cache", ENABLE(compile_cache)),
+
       std::make_pair("debug", ENABLE(debug)),
 
       std::make_pair("experimental", ENABLE(experimental)),
 
+      std::make_pair("optimize", ENABLE(optimize)),
+
       std::make_pair("help", [&](const auto&)
       {
         std::cout << "; rather, help me." << std::endl;
@@ -136,7 +188,7 @@ namespace meevax::kernel
       std::make_pair("verbose-compiler",    ENABLE(verbose_compiler)),
       std::make_pair("verbose-define",      ENABLE(verbose_define)),
       std::make_pair("verbose-environment", ENABLE(verbose_environment)),
-      std::make_pair("verbose-linker",      ENABLE(posix::verbose_linker)),
+      std::make_pair("verbose-linker",      ENABLE(verbose_linker)),
       std::make_pair("verbose-loader",      ENABLE(verbose_loader)),
       std::make_pair("verbose-machine",     ENABLE(verbose_machine)),
       std::make_pair("verbose-reader",      ENABLE(verbose_reader)),
@@ -159,6 +211,14 @@ namespace meevax::kernel
 
     const dispatcher<std::string> long_options_requires_operands
     {
+      std::make_pair("build-executable", PATHNAME(executable_file)),
+
+      std::make_pair("cache-directory", PATHNAME(cache_directory)),
+
+      std::make_pair("client", PATHNAME(client_socket)),
+
+      std::make_pair("dump-image", PATHNAME(dump_file)),
+
       std::make_pair("echo", [](const auto& operands)
       {
         std::cout << operands << std::endl;
@@ -172,6 +232,25 @@ namespace meevax::kernel
         std::cerr << variable << std::endl;
         return variable;
       }),
+
+      std::make_pair("image", PATHNAME(image_file)),
+
+      std::make_pair("library-directory", PATHNAME(library_directory)),
+
+      std::make_pair("server", PATHNAME(server_socket)),
+
+      std::make_pair("workers", [&](const auto& operands) mutable
+      {
+        if (not operands or not operands.template is<real>() or operands.template as<real>() < 1)
+        {
+          throw configuration_error {operands, " is not a positive number of workers"};
+        }
+
+        parse_trace << ";\t\t; " << workers << " => ";
+        workers = operands;
+        parse_trace << workers << std::endl;
+        return workers;
+      }),
     };
 
     template <typename... Ts>
@@ -180,55 +259,110 @@ namespace meevax::kernel
       return (*this)(std::forward<decltype(operands)>(operands)...);
     }
 
+    void operator()(const configurator& another)
+    {
+      script_file         = another.script_file;
+      command_line        = another.command_line;
+      debug               = another.debug;
+      experimental        = another.experimental;
+      optimize            = another.optimize;
+      trace               = another.trace;
+      variable            = another.variable;
+      verbose             = another.verbose;
+      verbose_compiler    = another.verbose_compiler;
+      verbose_define      = another.verbose_define;
+      verbose_environment = another.verbose_environment;
+      verbose_linker      = another.verbose_linker;
+      verbose_loader      = another.verbose_loader;
+      verbose_machine     = another.verbose_machine;
+      verbose_reader      = another.verbose_reader;
+      workers             = another.workers;
+      image_file          = another.image_file;
+      dump_file           = another.dump_file;
+      compile_cache       = another.compile_cache;
+      cache_directory     = another.cache_directory;
+      library_directory   = another.library_directory;
+      server_socket       = another.server_socket;
+      client_socket       = another.client_socket;
+      executable_file     = another.executable_file;
+    }
+
     decltype(auto) operator()(const int argc, char const* const* const argv)
     {
+      command_line = arguments(argv, argv + 1);
+
       const std::vector<std::string> options {argv + 1, argv + argc};
       return (*this)(options);
     }
 
+    /* ------------------------------------------------------------------------
+    * The command line as a list of strings (see "command-line").
+    *----------------------------------------------------------------------- */
+    template <typename Iterator>
+    static auto arguments(Iterator first, Iterator last)
+    {
+      object result {unit};
+
+      while (first != last)
+      {
+        const std::string argument {*--last};
+
+        object s {unit};
+
+        for (auto iter {std::rbegin(argument)}; iter != std::rend(argument); ++iter)
+        {
+          s = make<string>(make<character>(*iter), s);
+        }
+
+        result = cons(s, result);
+      }
+
+      return result;
+    }
+
     void operator()(const std::vector<std::string>& args)
     {
       static const std::regex pattern {"--([[:alnum:]][-_[:alnum:]]+)(=(.*))?|-([[:alnum:]]+)"};
 
       for (auto global {std::begin(args)}; global != std::end(args); ++global) [&]()
       {
-        std::cerr << ";" << std::endl
-                  << "; configure\t; " << *global << std::endl;
+        parse_trace << ";" << std::endl
+                    << "; configure\t; " << *global << std::endl;
 
         std::smatch group {};
         std::regex_match(*global, group, pattern);
 
-        std::cerr << ";\t\t; group[0] " << group[0] << std::endl;
-        std::cerr << ";\t\t; group[1] " << group[1] << std::endl;
-        std::cerr << ";\t\t; group[2] " << group[2] << std::endl;
-        std::cerr << ";\t\t; group[3] " << group[3] << std::endl;
-        std::cerr << ";\t\t; group[4] " << group[4] << std::endl;
+        parse_trace << ";\t\t; group[0] " << group[0] << std::endl;
+        parse_trace << ";\t\t; group[1] " << group[1] << std::endl;
+        parse_trace << ";\t\t; group[2] " << group[2] << std::endl;
+        parse_trace << ";\t\t; group[3] " << group[3] << std::endl;
+        parse_trace << ";\t\t; group[4] " << group[4] << std::endl;
 
         if (group[4].length() != 0) // short-option
         {
           const auto buffer {group.str(4)};
-          std::cerr << ";\t\t; search short-options " << buffer << std::endl;
+          parse_trace << ";\t\t; search short-options " << buffer << std::endl;
 
           for (auto local {std::begin(buffer)}; local != std::end(buffer); ++local)
           {
-            std::cerr << ";\t\t; search short-option " << *local << std::endl;
+            parse_trace << ";\t\t; search short-option " << *local << std::endl;
 
             if (auto callee_requires_operands {short_options_requires_operands.find(*local)};
                 callee_requires_operands != std::end(short_options_requires_operands))
             {
-              std::cerr << ";\t\t; found short-option " << *local << " (requires operands)" << std::endl;
+              parse_trace << ";\t\t; found short-option " << *local << " (requires operands)" << std::endl;
 
               if (const std::string subsequent {std::next(local), std::end(buffer)}; not subsequent.empty())
               {
                 const auto operands {static_cast<Environment&>(*this).read(subsequent)};
-                std::cerr << ";\t\t; operand(s) " << operands << std::endl;
+                parse_trace << ";\t\t; operand(s) " << operands << std::endl;
                 return std::invoke(std::get<1>(*callee_requires_operands), operands);
               }
               else if (std::smatch next_group {};
                        std::next(global) != std::end(args)
                        and not std::regex_match(*std::next(global), next_group, pattern))
               {
-                std::cerr << ";\t\t; operand(s) " << *std::next(global) << std::endl;
+                parse_trace << ";\t\t; operand(s) " << *std::next(global) << std::endl;
                 return std::invoke(std::get<1>(*callee_requires_operands), static_cast<Environment&>(*this).read(*++global));
               }
               else
@@ -250,27 +384,27 @@ namespace meevax::kernel
         else if (group[1].length() != 0) // long option
         {
           const auto buffer {group.str(1)};
-          std::cerr << ";\t\t; search long-option " << buffer << std::endl;
+          parse_trace << ";\t\t; search long-option " << buffer << std::endl;
 
           if (auto callee_requires_operands {long_options_requires_operands.find(buffer)};
               callee_requires_operands != std::end(long_options_requires_operands))
           {
-            std::cerr << ";\t\t; found long-option " << buffer << " (requires operands)" << std::endl;
+            parse_trace << ";\t\t; found long-option " << buffer << " (requires operands)" << std::endl;
 
             if (group.length(2) != 0)
             {
-              std::cerr << ";\t\t; operand(s) \"" << group.str(3) << "\" => ";
+              parse_trace << ";\t\t; operand(s) \"" << group.str(3) << "\" => ";
               const auto operands {static_cast<Environment&>(*this).read(group.str(3))};
-              std::cerr << operands << std::endl;
+              parse_trace << operands << std::endl;
               return std::invoke(std::get<1>(*callee_requires_operands), operands);
             }
             else if (std::smatch next_group {};
                      std::next(global) != std::end(args)
                      and not std::regex_match(*std::next(global), next_group, pattern))
             {
-              std::cerr << ";\t\t; operand(s) \"" << *std::next(global) << "\" => ";
+              parse_trace << ";\t\t; operand(s) \"" << *std::next(global) << "\" => ";
               const auto operands {static_cast<Environment&>(*this).read(*++global)};
-              std::cerr << operands << std::endl;
+              parse_trace << operands << std::endl;
               return std::invoke(std::get<1>(*callee_requires_operands), operands);
             }
             else
@@ -281,7 +415,7 @@ namespace meevax::kernel
           else if (auto callee_requires_no_operands {long_options_requires_no_operands.find(buffer)};
                    callee_requires_no_operands != std::end(long_options_requires_no_operands))
           {
-            std::cerr << ";\t\t; found long-option " << buffer << " (requires no operands)" << std::endl;
+            parse_trace << ";\t\t; found long-option " << buffer << " (requires no operands)" << std::endl;
             return std::invoke(std::get<1>(*callee_requires_no_operands), unit);
           }
           else
@@ -291,14 +425,21 @@ namespace meevax::kernel
         }
         else
         {
-          const auto filename {make<path>(*global)};
-          std::cerr << ";\t\t; append " << filename << " to preloads" << std::endl;
-          preloads = append(preloads, filename);
-          std::cerr << ";\t\t; preloads " << preloads << std::endl;
+          script_file = make<path>(*global);
+          command_line = arguments(global, std::end(args)); // the rest are of the script
+
+          global = std::prev(std::end(args));
         }
 
         return undefined;
       }();
+
+      if (verbose == true_object or debug == true_object)
+      {
+        std::cerr << parse_trace.str();
+      }
+
+      parse_trace.str({});
     }
   };
 } // namespace meevax::kernel
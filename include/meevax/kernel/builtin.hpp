@@ -0,0 +1,38 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_BUILTIN_HPP
+#define INCLUDED_MEEVAX_KERNEL_BUILTIN_HPP
+
+#include <unordered_map>
+
+#include <meevax/kernel/procedure.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Builtin Libraries
+  *
+  *   If the kernel is built with MEEVAX_BUILTIN_LIBRARIES (CMake option
+  *   BUILTIN_LIBRARIES), the standard libraries are compiled into it instead
+  *   of their own shared objects, and registered in this table by the name
+  *   of the shared object and the symbol, e.g. "libmeevax-pair.so car". The
+  *   linker resolves such symbols from the table without opening the shared
+  *   object (see posix::linker::link), so layer 1 is the same in both builds.
+  *
+  *   The arity is the number of required operands. A procedure that is not
+  *   variadic also rejects more operands than the arity.
+  *
+  *   The table is empty unless built with MEEVAX_BUILTIN_LIBRARIES.
+  *
+  *========================================================================= */
+  struct builtin
+  {
+    const procedure::signature function;
+
+    const std::size_t arity;
+
+    const bool variadic;
+  };
+
+  extern const std::unordered_map<std::string, builtin> builtins;
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_BUILTIN_HPP
@@ -0,0 +1,62 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_CELL_HPP
+#define INCLUDED_MEEVAX_KERNEL_CELL_HPP
+
+#include <atomic>
+
+#include <meevax/kernel/epoch.hpp>
+#include <meevax/kernel/pair.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  *
+  * Cell is a mutable binding shared by threads. The bound object is held in
+  * a heap-allocated box, and "store" publishes a new box by an atomic
+  * exchange instead of overwriting the object in place. "load" copies the
+  * object out of the box inside an epoch guard, so the box cannot be deleted
+  * while it is being read (see epoch.hpp).
+  *
+  * Global variables are always bound to cells. Local variables are put into
+  * cells only if some closure assigns them with set!.
+  *
+  *========================================================================= */
+  struct cell
+  {
+    std::atomic<const object*> box;
+
+    explicit cell(const object& value = unit)
+      : box {new object {value}}
+    {}
+
+    cell(const cell&) = delete;
+
+    cell& operator=(const cell&) = delete;
+
+    ~cell()
+    {
+      delete box.load(std::memory_order_relaxed);
+    }
+
+    auto load() const
+    {
+      const epoch::guard guard {};
+      return object {*box.load(std::memory_order_acquire)};
+    }
+
+    void store(const object& value)
+    {
+      epoch::retire(box.exchange(new object {value}, std::memory_order_acq_rel));
+    }
+  };
+
+  std::ostream& operator<<(std::ostream& os, const cell& cell)
+  {
+    return os << highlight::syntax << "#("
+              << highlight::constructor << "cell "
+              << attribute::normal << cell.load()
+              << highlight::syntax << ")"
+              << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_CELL_HPP
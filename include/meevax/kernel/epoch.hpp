@@ -0,0 +1,216 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_EPOCH_HPP
+#define INCLUDED_MEEVAX_KERNEL_EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility> // std::pair
+#include <vector>
+
+#include <meevax/kernel/object.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  *
+  * Epoch-Based Reclamation
+  *
+  *   Readers enter a critical section (epoch::guard) before dereferencing a
+  *   box loaded from a cell, and leave it after taking their own reference to
+  *   the boxed object. Writers unlink boxes by exchange and retire them. A
+  *   retired box is deleted after the global epoch has advanced twice, at
+  *   which point no reader can still see it. The global epoch advances only
+  *   when every thread in a critical section has announced the current one.
+  *
+  *   Neither side takes a lock. Readers store to their own announcement slot
+  *   and writers exchange a pointer. Reclamation is amortized over retirements.
+  *   Boxes left by an exiting thread are handed over through a lock-free stack.
+  *
+  *======================================================================= */
+  class epoch
+  {
+    using epoch_type = std::uint64_t;
+
+    static constexpr epoch_type quiescent {~epoch_type {0}};
+
+    static constexpr std::size_t threshold {64}; // retirements per reclamation
+
+    struct participant
+    {
+      std::atomic<epoch_type> announced {quiescent};
+
+      std::atomic<bool> occupied {true};
+
+      participant* next {nullptr};
+    };
+
+    using garbage = std::vector<std::pair<epoch_type, const object*>>;
+
+    struct orphan
+    {
+      garbage boxes;
+
+      orphan* next {nullptr};
+    };
+
+    static inline std::atomic<epoch_type> global {0};
+
+    static inline std::atomic<participant*> participants {nullptr};
+
+    static inline std::atomic<orphan*> orphans {nullptr};
+
+    struct local_state
+    {
+      participant* const self {join()};
+
+      std::size_t depth {0};
+
+      garbage retired {};
+
+      ~local_state()
+      {
+        if (not retired.empty())
+        {
+          adopt(new orphan {std::move(retired)});
+        }
+
+        self->announced.store(quiescent, std::memory_order_release);
+        self->occupied.store(false, std::memory_order_release);
+      }
+    };
+
+    static auto& local()
+    {
+      static thread_local local_state state {};
+      return state;
+    }
+
+    // Reuse a participant left by an exited thread, or register a new one.
+    static participant* join()
+    {
+      for (auto* each {participants.load(std::memory_order_acquire)}; each; each = each->next)
+      {
+        if (bool expected {false}; each->occupied.compare_exchange_strong(expected, true))
+        {
+          return each;
+        }
+      }
+
+      auto* self {new participant {}};
+
+      self->next = participants.load(std::memory_order_relaxed);
+
+      while (not participants.compare_exchange_weak(self->next, self))
+      {}
+
+      return self;
+    }
+
+    static void adopt(orphan* o)
+    {
+      o->next = orphans.load(std::memory_order_relaxed);
+
+      while (not orphans.compare_exchange_weak(o->next, o))
+      {}
+    }
+
+    static bool advance()
+    {
+      auto current {global.load(std::memory_order_seq_cst)};
+
+      for (auto* each {participants.load(std::memory_order_acquire)}; each; each = each->next)
+      {
+        if (const auto announced {each->announced.load(std::memory_order_seq_cst)};
+            announced != quiescent and announced != current)
+        {
+          return false;
+        }
+      }
+
+      return global.compare_exchange_strong(current, current + 1);
+    }
+
+    static void reclaim(garbage& boxes)
+    {
+      const auto current {global.load(std::memory_order_acquire)};
+
+      auto iter {std::begin(boxes)};
+
+      for (auto&& each : boxes)
+      {
+        if (each.first + 2 <= current)
+        {
+          delete each.second;
+        }
+        else
+        {
+          *iter++ = each;
+        }
+      }
+
+      boxes.erase(iter, std::end(boxes));
+    }
+
+    static void reclaim_orphans()
+    {
+      for (auto* o {orphans.exchange(nullptr, std::memory_order_acquire)}; o; )
+      {
+        auto* const next {o->next};
+
+        reclaim(o->boxes);
+
+        if (o->boxes.empty())
+        {
+          delete o;
+        }
+        else
+        {
+          adopt(o);
+        }
+
+        o = next;
+      }
+    }
+
+  public:
+    struct guard
+    {
+      guard()
+      {
+        if (auto& state {local()}; state.depth++ == 0)
+        {
+          state.self->announced.store(global.load(std::memory_order_relaxed), std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+      }
+
+      ~guard()
+      {
+        if (auto& state {local()}; --state.depth == 0)
+        {
+          state.self->announced.store(quiescent, std::memory_order_release);
+        }
+      }
+
+      guard(const guard&) = delete;
+
+      guard& operator=(const guard&) = delete;
+    };
+
+    // The box must already be unreachable from any cell.
+    static void retire(const object* box)
+    {
+      auto& state {local()};
+
+      state.retired.emplace_back(global.load(std::memory_order_acquire), box);
+
+      if (threshold <= std::size(state.retired))
+      {
+        advance();
+        reclaim(state.retired);
+        reclaim_orphans();
+      }
+    }
+  };
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_EPOCH_HPP
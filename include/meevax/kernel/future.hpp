@@ -0,0 +1,103 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_FUTURE_HPP
+#define INCLUDED_MEEVAX_KERNEL_FUTURE_HPP
+
+#include <atomic>
+#include <exception> // std::exception_ptr
+
+#include <meevax/kernel/pair.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  *
+  * Future is a pair of thunk and global-environment, with a state shared by
+  * all copies of it. The thunk is evaluated exactly once, either by a worker
+  * of the thread pool or by the first thread that touches it before any
+  * worker starts it (steal). The syntactic_continuation is responsible for
+  * evaluation; this class only provides the state transition.
+  *
+  *   pending ---(claim)---> running ---(resolve/reject)---> ready
+  *
+  *========================================================================= */
+  struct future
+    : public virtual pair
+  {
+    enum class status
+    {
+      pending, running, ready,
+    };
+
+    struct state
+    {
+      std::atomic<status> current {status::pending};
+
+      object value {unit};
+
+      std::exception_ptr exception {nullptr};
+    };
+
+    const std::shared_ptr<state> shared {std::make_shared<state>()};
+
+    template <typename... Ts>
+    explicit future(Ts&&... operands)
+      : pair {std::forward<decltype(operands)>(operands)...}
+    {}
+
+    decltype(auto) procedure() const
+    {
+      return std::get<0>(*this);
+    }
+
+    decltype(auto) environment() const
+    {
+      return std::get<1>(*this);
+    }
+
+    auto claim() const
+    {
+      auto expected {status::pending};
+      return shared->current.compare_exchange_strong(expected, status::running);
+    }
+
+    auto ready() const
+    {
+      return shared->current == status::ready;
+    }
+
+    void resolve(const object& value) const
+    {
+      shared->value = value;
+      shared->current = status::ready;
+    }
+
+    void reject(const std::exception_ptr& exception) const
+    {
+      shared->exception = exception;
+      shared->current = status::ready;
+    }
+
+    // Call after ready() returned true.
+    const auto& get() const
+    {
+      if (shared->exception)
+      {
+        std::rethrow_exception(shared->exception);
+      }
+      else
+      {
+        return shared->value;
+      }
+    }
+  };
+
+  std::ostream& operator<<(std::ostream& os, const future& future)
+  {
+    return os << highlight::syntax << "#("
+              << highlight::constructor << "future"
+              << attribute::normal << highlight::comment << " #;" << &future << attribute::normal
+              << highlight::syntax << ")"
+              << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_FUTURE_HPP
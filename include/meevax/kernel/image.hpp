@@ -0,0 +1,1176 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_IMAGE_HPP
+#define INCLUDED_MEEVAX_KERNEL_IMAGE_HPP
+
+#include <algorithm> // std::set_difference
+#include <cstdint>
+#include <fstream>
+#include <iterator> // std::back_inserter
+#include <numeric> // std::accumulate
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <dlfcn.h> // dladdr, dlopen
+
+#include <meevax/kernel/cell.hpp>
+#include <meevax/kernel/character.hpp>
+#include <meevax/kernel/closure.hpp>
+#include <meevax/kernel/continuation.hpp>
+#include <meevax/kernel/instruction.hpp>
+#include <meevax/kernel/library.hpp>
+#include <meevax/kernel/numerical.hpp>
+#include <meevax/kernel/procedure.hpp>
+#include <meevax/kernel/special.hpp>
+#include <meevax/kernel/string.hpp>
+#include <meevax/kernel/stub.hpp>
+#include <meevax/kernel/symbol.hpp>
+#include <meevax/kernel/transformer.hpp>
+#include <meevax/kernel/values.hpp>
+#include <meevax/posix/linker.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Heap Image
+  *
+  *   A heap image is a snapshot of the global environment of a booted
+  *   syntactic_continuation, with everything reachable from it (symbols,
+  *   closures, macros and compiled code). "--dump-image=FILE" writes it after
+  *   layer 1 is booted, and "--image=FILE" reads it back instead of reading,
+  *   compiling and evaluating layer 1 again.
+  *
+  *   Objects are numbered in the order of a depth-first walk, and the image
+  *   is the sequence of their records, in which references to other objects
+  *   are replaced with their numbers (0 is unit). Restoring allocates every
+  *   object first and fills the references after, so shared structure and
+  *   cycles come back as they were.
+  *
+  *   Objects owned by the process (kernel constants, named characters) or by
+  *   layer 0 (special forms and procedures, which close the syntactic
+  *   continuation) are recorded by name, and resolved against the restoring
+  *   syntactic_continuation. A native procedure is recorded as the pair of
+  *   its linker and symbol name, and linked again by its first application
+  *   (see posix::symbol). A library is recorded by its name and the names of
+  *   its slots and exports, and resolved against the libraries of the
+  *   restoring syntactic_continuation (see restore_library), so the code of
+  *   its importers refers to the slots of the same library.
+  *
+  *   An image is valid only for the build that wrote it. The header has the
+  *   format version and the build date and hash, and the image of another
+  *   build is rejected. It also has the size and the checksum of the records,
+  *   which are verified before any object is allocated, so a damaged image is
+  *   rejected rather than restored.
+  *
+  *   The compiled code of a file loaded by "load" is cached in the same
+  *   format (see "dump_code"), and so is the tree-shaken image of a program
+  *   embedded into a standalone executable (see "dump_program").
+  *
+  *========================================================================= */
+  template <typename SyntacticContinuation>
+  class image
+  {
+    static constexpr auto magic {"#!meevax-image"};
+
+    static constexpr std::size_t format_version {5};
+
+    enum class tag : std::uint8_t
+    {
+      pair, closure, continuation, string, stub, transformer, values, // car and cdr
+
+      boolean, character, constant, interned_symbol, linker, named_character,
+      procedure, real, special, symbol, instruction,
+
+      cell, jump_table, label, native,
+
+      library,
+    };
+
+    static inline const std::vector<object> constants
+    {
+      unbound, undefined, unspecified
+    };
+
+    static void write_size(std::ostream& port, std::size_t n)
+    {
+      for (; 0x7F < n; n >>= 7)
+      {
+        port.put(static_cast<char>((n & 0x7F) | 0x80));
+      }
+
+      port.put(static_cast<char>(n));
+    }
+
+    static void write_string(std::ostream& port, const std::string& s)
+    {
+      write_size(port, std::size(s));
+      port.write(s.data(), std::size(s));
+    }
+
+    static auto read_size(std::istream& port)
+    {
+      std::size_t n {0};
+
+      for (std::size_t shift {0}; ; shift += 7)
+      {
+        if (const auto c {port.get()}; c == std::istream::traits_type::eof() or 63 < shift)
+        {
+          throw kernel_error {"broken heap image"};
+        }
+        else if (n |= static_cast<std::size_t>(c & 0x7F) << shift; not (c & 0x80))
+        {
+          return n;
+        }
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * The records are read from the verified payload in memory (see
+    * read_image), and every element counted takes at least one character of
+    * it, so the number of characters left bounds the count.
+    *----------------------------------------------------------------------- */
+    static auto read_count(std::istream& port)
+    {
+      const auto n {read_size(port)};
+
+      if (const auto available {port.rdbuf()->in_avail()}; available < 0 or static_cast<std::size_t>(available) < n)
+      {
+        throw kernel_error {"broken heap image"};
+      }
+
+      return n;
+    }
+
+    static auto read_tag(std::istream& port)
+    {
+      if (const auto c {port.get()}; 0 <= c and c <= static_cast<int>(tag::library))
+      {
+        return static_cast<tag>(c);
+      }
+      else
+      {
+        throw kernel_error {"broken heap image"};
+      }
+    }
+
+    static auto read_string(std::istream& port)
+    {
+      std::string s (read_count(port), '\0');
+
+      if (not port.read(s.data(), std::size(s)))
+      {
+        throw kernel_error {"broken heap image"};
+      }
+
+      return s;
+    }
+
+    static auto signature()
+    {
+      using configurator = kernel::configurator<SyntacticContinuation>;
+
+      /* ----------------------------------------------------------------------
+      * The build hash is empty (that is, unit) if the source tree is not a
+      * git repository, e.g. extracted from a tarball.
+      *--------------------------------------------------------------------- */
+      auto text = [](const object& x) -> std::string
+      {
+        return x and x.is<string>() ? static_cast<std::string>(x.as<string>()) : "";
+      };
+
+      return std::to_string(format_version) + " "
+           + text(configurator::build.date) + " "
+           + text(configurator::build.hash);
+    }
+
+    static auto native(const procedure& procedure) -> procedure::signature
+    {
+      if (const auto* function {procedure.template target<procedure::signature>()}; function)
+      {
+        return *function;
+      }
+      else
+      {
+        return nullptr;
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * Every object is a pair (see pointer::binder), but only the following
+    * types use it as their contents.
+    *----------------------------------------------------------------------- */
+    static bool is_pair(const object& x)
+    {
+      return x and (x.is<pair>() or x.is<closure>() or x.is<continuation>() or
+                    x.is<string>() or x.is<stub>() or x.is<transformer>() or
+                    x.is<values>());
+    }
+
+    auto& self()
+    {
+      return static_cast<SyntacticContinuation&>(*this);
+    }
+
+    void write_header(std::ostream& port, const std::string& key)
+    {
+      port << magic << "\n" << signature() << "\n" << key << "\n";
+    }
+
+    /* ------------------------------------------------------------------------
+    * FNV-1a, which is enough to detect damage (not tampering).
+    *----------------------------------------------------------------------- */
+    static auto checksum(const std::string& payload)
+    {
+      std::uint64_t hash {0xCBF29CE484222325};
+
+      for (const auto c : payload)
+      {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001B3;
+      }
+
+      std::stringstream ss {};
+      ss << std::size(payload) << " " << std::hex << hash;
+      return ss.str();
+    }
+
+    void read_header(std::istream& port, const std::string& key)
+    {
+      if (std::string line {}; not std::getline(port, line) or line != magic)
+      {
+        throw kernel_error {"not a heap image"};
+      }
+      else if (not std::getline(port, line) or line != signature())
+      {
+        throw kernel_error {"heap image of another build (", line, ")"};
+      }
+      else if (not std::getline(port, line) or line != key)
+      {
+        throw kernel_error {"heap image of another key (", line, ")"};
+      }
+    }
+
+    void write_image(std::ostream& port, const std::string& key, const std::vector<object>& roots, const bool contained = false)
+    {
+      std::ostringstream payload {};
+
+      write_objects(payload, roots, contained);
+
+      write_header(port, key);
+
+      port << checksum(payload.str()) << "\n" << payload.str();
+    }
+
+    auto read_image(std::istream& port, const std::string& key)
+    {
+      read_header(port, key);
+
+      std::string line {};
+
+      std::getline(port, line);
+
+      std::istringstream payload {std::string {std::istreambuf_iterator<char> {port}, {}}};
+
+      if (line != checksum(payload.str()))
+      {
+        throw kernel_error {"broken heap image (checksum mismatch)"};
+      }
+
+      return read_objects(payload);
+    }
+
+    /* ------------------------------------------------------------------------
+    * Unless "contained", the slots of libraries are not written, and the
+    * restoring syntactic_continuation loads the libraries from their files
+    * (see restore_library).
+    *----------------------------------------------------------------------- */
+    void write_objects(std::ostream& port, const std::vector<object>& roots, const bool contained = false)
+    {
+      using label = typename SyntacticContinuation::label;
+      using jump_table = typename SyntacticContinuation::jump_table;
+
+      std::vector<object> objects {unit};
+
+      std::unordered_map<const pair*, std::size_t> indices {{nullptr, 0}};
+
+      std::unordered_map<const pair*, object> linkers; // of native procedures
+
+      for (std::vector<object> pending (std::rbegin(roots), std::rend(roots)); not std::empty(pending); )
+      {
+        const object x {pending.back()};
+
+        pending.pop_back();
+
+        if (not x or not indices.emplace(x.get(), std::size(objects)).second)
+        {
+          continue;
+        }
+
+        objects.push_back(x);
+
+        if (is_pair(x))
+        {
+          pending.push_back(cdr(x));
+          pending.push_back(car(x));
+        }
+        else if (x.is<cell>())
+        {
+          pending.push_back(x.as<cell>().load());
+        }
+        else if (x.is<label>())
+        {
+          pending.push_back(x.as<label>().code);
+        }
+        else if (x.is<jump_table>())
+        {
+          pending.push_back(x.as<jump_table>().otherwise);
+
+          for (const auto& [hash, branch] : x.as<jump_table>().branches)
+          {
+            pending.push_back(branch.first);
+            pending.push_back(branch.second);
+          }
+        }
+        else if (x.is<procedure>())
+        {
+          if (const auto* linked {x.as<procedure>().template target<posix::symbol>()}; linked)
+          {
+            pending.push_back(linkers[x.get()] = linked->linker);
+          }
+        }
+        else if (x.is<library>())
+        {
+          for (const object& each : car(x))
+          {
+            pending.push_back(each);
+          }
+
+          std::copy(std::begin(x.as<library>().names), std::end(x.as<library>().names), std::back_inserter(pending));
+          std::copy(std::begin(x.as<library>().exported), std::end(x.as<library>().exported), std::back_inserter(pending));
+
+          if (contained)
+          {
+            std::copy(std::begin(x.as<library>().slots), std::end(x.as<library>().slots), std::back_inserter(pending));
+          }
+        }
+      }
+
+      /* ----------------------------------------------------------------------
+      * The linker of a native procedure is found by the shared library which
+      * defines it. A library opened by no linker in the heap gets a new one.
+      *--------------------------------------------------------------------- */
+      for (std::size_t index {1}; index < std::size(objects); ++index)
+      {
+        if (const object x {objects[index]}; x.is<procedure>() and native(x.as<procedure>()))
+        {
+          Dl_info info {};
+
+          if (not dladdr(reinterpret_cast<void*>(native(x.as<procedure>())), &info))
+          {
+            throw kernel_error {"no shared library defines native procedure ", x.as<procedure>().name};
+          }
+
+          void* const handle {dlopen(info.dli_fname, RTLD_LAZY | RTLD_NOLOAD)};
+
+          for (const auto& each : objects)
+          {
+            if (each and each.is<posix::linker>() and each.as<posix::linker>().handle() == handle)
+            {
+              linkers[x.get()] = each;
+              break;
+            }
+          }
+
+          if (handle)
+          {
+            dlclose(handle);
+          }
+
+          if (not linkers[x.get()])
+          {
+            const auto linker {make<posix::linker>(info.dli_fname, self().verbose_linker)};
+            indices.emplace(linker.get(), std::size(objects));
+            objects.push_back(linker);
+            linkers[x.get()] = linker;
+          }
+        }
+      }
+
+      write_size(port, std::size(objects));
+
+      auto reference = [&](const object& x)
+      {
+        write_size(port, indices.at(x.get()));
+      };
+
+      auto record = [&](tag t)
+      {
+        port.put(static_cast<char>(t));
+      };
+
+      for (std::size_t index {1}; index < std::size(objects); ++index)
+      {
+        const object& x {objects[index]};
+
+        if (x.is<pair>())
+        {
+          record(tag::pair);
+        }
+        else if (x.is<closure>())
+        {
+          record(tag::closure);
+        }
+        else if (x.is<continuation>())
+        {
+          record(tag::continuation);
+        }
+        else if (x.is<string>())
+        {
+          record(tag::string);
+        }
+        else if (x.is<stub>())
+        {
+          record(tag::stub);
+        }
+        else if (x.is<transformer>())
+        {
+          record(tag::transformer);
+          write_size(port, x.as<transformer>().time_stamp);
+        }
+        else if (x.is<values>())
+        {
+          record(tag::values);
+        }
+        else if (x.is<boolean>())
+        {
+          record(tag::boolean);
+          write_size(port, static_cast<std::size_t>(static_cast<bool>(x.as<boolean>())));
+        }
+        else if (x.is<character>())
+        {
+          if (auto iter {std::find_if(std::begin(characters), std::end(characters), [&](const auto& each)
+                          {
+                            return each.second == x;
+                          })}; iter != std::end(characters))
+          {
+            record(tag::named_character);
+            write_string(port, iter->first);
+          }
+          else
+          {
+            record(tag::character);
+            write_string(port, x.as<const std::string>());
+            write_string(port, x.as<character>().external_repsesentaion);
+          }
+        }
+        else if (x.is<exception>())
+        {
+          if (auto iter {std::find(std::begin(constants), std::end(constants), x)}; iter != std::end(constants))
+          {
+            record(tag::constant);
+            write_size(port, static_cast<std::size_t>(std::distance(std::begin(constants), iter)));
+          }
+          else
+          {
+            throw kernel_error {"heap image cannot contain exception ", x};
+          }
+        }
+        else if (x.is<symbol>())
+        {
+          const auto& name {x.as<const std::string>()};
+
+          if (auto iter {self().symbols.find(name)}; iter != std::end(self().symbols) and iter->second == x)
+          {
+            record(tag::interned_symbol);
+          }
+          else
+          {
+            record(tag::symbol);
+          }
+
+          write_string(port, name);
+        }
+        else if (x.is<real>())
+        {
+          record(tag::real);
+          write_string(port, x.as<real>().str(0));
+        }
+        else if (x.is<instruction>())
+        {
+          record(tag::instruction);
+          write_size(port, static_cast<std::size_t>(x.as<instruction>().code));
+        }
+        else if (x.is<special>())
+        {
+          record(tag::special);
+          write_string(port, x.as<special>().name);
+        }
+        else if (x.is<procedure>())
+        {
+          if (linkers.count(x.get()))
+          {
+            record(tag::native);
+            reference(linkers.at(x.get()));
+          }
+          else
+          {
+            record(tag::procedure);
+          }
+
+          write_string(port, x.as<procedure>().name);
+        }
+        else if (x.is<posix::linker>())
+        {
+          record(tag::linker);
+          write_string(port, x.as<posix::linker>().path());
+        }
+        else if (x.is<cell>())
+        {
+          record(tag::cell);
+          reference(x.as<cell>().load());
+        }
+        else if (x.is<label>())
+        {
+          record(tag::label);
+          reference(x.as<label>().code);
+        }
+        else if (x.is<jump_table>())
+        {
+          record(tag::jump_table);
+          reference(x.as<jump_table>().otherwise);
+          write_size(port, std::size(x.as<jump_table>().branches));
+
+          for (const auto& [hash, branch] : x.as<jump_table>().branches)
+          {
+            reference(branch.first);
+            reference(branch.second);
+          }
+        }
+        else if (x.is<library>())
+        {
+          record(tag::library);
+          write_size(port, length(car(x)));
+
+          for (const object& each : car(x))
+          {
+            reference(each);
+          }
+
+          write_size(port, std::size(x.as<library>().names));
+
+          for (const auto& each : x.as<library>().names)
+          {
+            reference(each);
+          }
+
+          write_size(port, std::size(x.as<library>().exported));
+
+          for (const auto& each : x.as<library>().exported)
+          {
+            reference(each);
+            write_size(port, x.as<library>().exports.at(each.get()));
+          }
+
+          write_size(port, contained ? std::size(x.as<library>().slots) : 0);
+
+          for (const auto& each : contained ? x.as<library>().slots : std::vector<object> {})
+          {
+            reference(each);
+          }
+        }
+        else
+        {
+          throw kernel_error {"heap image cannot contain object of type ", utility::demangle(x.type())};
+        }
+
+        if (is_pair(x))
+        {
+          reference(car(x));
+          reference(cdr(x));
+        }
+      }
+
+      write_size(port, std::size(roots));
+
+      for (const auto& each : roots)
+      {
+        reference(each);
+      }
+    }
+
+    auto read_objects(std::istream& port)
+    {
+      using label = typename SyntacticContinuation::label;
+      using jump_table = typename SyntacticContinuation::jump_table;
+
+      /* ----------------------------------------------------------------------
+      * Special forms and procedures of layer 0 close this syntactic
+      * continuation, so they are taken from its environment by name.
+      *--------------------------------------------------------------------- */
+      std::unordered_map<std::string, object> primitives;
+
+      for (const object& each : self().interaction_environment())
+      {
+        if (const object value {cadr(each).template as<cell>().load()}; value.is<special>())
+        {
+          primitives.emplace(value.as<special>().name, value);
+        }
+        else if (value.is<procedure>() and not native(value.as<procedure>())
+                                       and not value.as<procedure>().template target<posix::symbol>())
+        {
+          primitives.emplace(value.as<procedure>().name, value);
+        }
+      }
+
+      auto primitive = [&](const std::string& name)
+      {
+        if (auto iter {primitives.find(name)}; iter != std::end(primitives))
+        {
+          return iter->second;
+        }
+        else
+        {
+          throw kernel_error {"heap image requires unknown primitive ", name};
+        }
+      };
+
+      std::vector<object> objects (read_count(port));
+
+      if (std::empty(objects))
+      {
+        throw kernel_error {"broken heap image"};
+      }
+
+      auto reference = [&]() -> std::size_t
+      {
+        if (const auto index {read_size(port)}; index < std::size(objects))
+        {
+          return index;
+        }
+        else
+        {
+          throw kernel_error {"broken heap image"};
+        }
+      };
+
+      std::vector<std::size_t> references (std::size(objects) * 2);
+
+      std::vector<std::tuple<std::size_t, std::size_t, std::string>> natives;
+
+      std::vector<std::size_t> labels;
+
+      std::vector<std::tuple<std::size_t, std::vector<std::size_t>, std::vector<std::size_t>, std::vector<std::pair<std::size_t, std::size_t>>, std::vector<std::size_t>>> libraries;
+
+      std::vector<std::vector<std::size_t>> branches (std::size(objects));
+
+      for (std::size_t index {1}; index < std::size(objects); ++index)
+      {
+        auto& x {objects[index]};
+
+        switch (const auto t {read_tag(port)}; t)
+        {
+        case tag::pair:
+          x = cons(unit, unit);
+          break;
+
+        case tag::closure:
+          x = make<closure>(unit, unit);
+          break;
+
+        case tag::continuation:
+          x = make<continuation>(unit, unit);
+          break;
+
+        case tag::string:
+          x = make<string>(unit, unit);
+          break;
+
+        case tag::stub:
+          x = make<stub>(unit, unit);
+          ++stub::deferred;
+          break;
+
+        case tag::transformer:
+          x = make<transformer>(unit, unit);
+          x.as<transformer>().time_stamp = read_size(port);
+          break;
+
+        case tag::values:
+          x = make<values>(unit, unit);
+          break;
+
+        case tag::boolean:
+          x = read_size(port) ? true_object : false_object;
+          break;
+
+        case tag::character:
+          {
+            const auto s {read_string(port)};
+            x = make<character>(s, read_string(port));
+          }
+          break;
+
+        case tag::named_character:
+          if (const auto iter {characters.find(read_string(port))}; iter != std::end(characters))
+          {
+            x = iter->second;
+          }
+          else
+          {
+            throw kernel_error {"broken heap image"};
+          }
+          break;
+
+        case tag::constant:
+          if (const auto n {read_size(port)}; n < std::size(constants))
+          {
+            x = constants[n];
+          }
+          else
+          {
+            throw kernel_error {"broken heap image"};
+          }
+          break;
+
+        case tag::interned_symbol:
+          x = self().intern(read_string(port));
+          break;
+
+        case tag::symbol:
+          x = make<symbol>(read_string(port));
+          break;
+
+        case tag::real:
+          x = make<real>(read_string(port));
+          break;
+
+        case tag::instruction:
+          if (const auto n {read_size(port)}; n < BOOST_PP_SEQ_SIZE(MNEMONICS))
+          {
+            x = make<instruction>(static_cast<mnemonic>(n));
+          }
+          else
+          {
+            throw kernel_error {"broken heap image"};
+          }
+          break;
+
+        case tag::special:
+        case tag::procedure:
+          x = primitive(read_string(port));
+          break;
+
+        case tag::native:
+          {
+            const auto linker {reference()};
+            natives.emplace_back(index, linker, read_string(port));
+          }
+          break;
+
+        case tag::linker:
+          x = make<posix::linker>(read_string(port), self().verbose_linker);
+          break;
+
+        case tag::cell:
+          x = make<cell>();
+          references[index * 2] = reference();
+          break;
+
+        case tag::label:
+          labels.push_back(index);
+          references[index * 2] = reference();
+          break;
+
+        case tag::jump_table:
+          x = make<jump_table>();
+          references[index * 2] = reference();
+
+          for (auto size {read_size(port) * 2}; 0 < size; --size)
+          {
+            branches[index].push_back(reference());
+          }
+          break;
+
+        case tag::library:
+          {
+            std::vector<std::size_t> name (read_count(port)), names;
+
+            std::generate(std::begin(name), std::end(name), reference);
+
+            std::generate_n(std::back_inserter(names), read_count(port), reference);
+
+            std::vector<std::pair<std::size_t, std::size_t>> exports (read_count(port));
+
+            for (auto& [external, index] : exports)
+            {
+              external = reference();
+              index = read_size(port);
+            }
+
+            std::vector<std::size_t> slots (read_count(port));
+
+            std::generate(std::begin(slots), std::end(slots), reference);
+
+            libraries.emplace_back(index, name, names, exports, slots);
+          }
+          break;
+
+        default:
+          throw kernel_error {"broken heap image"};
+        }
+
+        if (is_pair(x))
+        {
+          references[index * 2 + 0] = reference();
+          references[index * 2 + 1] = reference();
+        }
+      }
+
+      for (const auto& [index, linker, name] : natives)
+      {
+        objects[index] = make<procedure>(name, posix::symbol {objects[linker], name});
+      }
+
+      /* ----------------------------------------------------------------------
+      * The names of a library are atoms and its slots are cells, which are
+      * allocated by now.
+      *--------------------------------------------------------------------- */
+      for (const auto& [index, name, names, exports, slots] : libraries)
+      {
+        auto resolve = [&](const auto& indices)
+        {
+          std::vector<object> result {};
+
+          for (const auto each : indices)
+          {
+            result.push_back(objects[each]);
+          }
+
+          return result;
+        };
+
+        std::vector<std::pair<object, std::size_t>> exported {};
+
+        for (const auto& [external, slot] : exports)
+        {
+          exported.emplace_back(objects[external], slot);
+        }
+
+        object library_name {unit};
+
+        for (auto iter {std::rbegin(name)}; iter != std::rend(name); ++iter)
+        {
+          library_name = cons(objects[*iter], library_name);
+        }
+
+        objects[index] = self().restore_library(library_name, resolve(names), exported, resolve(slots));
+      }
+
+      for (const auto index : labels)
+      {
+        objects[index] = make<label>(objects[references[index * 2]]);
+      }
+
+      for (std::size_t index {1}; index < std::size(objects); ++index)
+      {
+        if (const object& x {objects[index]}; x.is<cell>())
+        {
+          x.as<cell>().store(objects[references[index * 2]]);
+        }
+        else if (x.is<jump_table>())
+        {
+          auto& table {x.as<jump_table>()};
+
+          table.otherwise = objects[references[index * 2]];
+
+          for (auto iter {std::begin(branches[index])}; iter != std::end(branches[index]); iter += 2)
+          {
+            const auto& datum {objects[*iter]};
+            table.branches.emplace(jump_table::hash(datum), std::make_pair(datum, objects[*std::next(iter)]));
+          }
+        }
+        else if (is_pair(x))
+        {
+          std::get<0>(x.as<pair>()) = objects[references[index * 2 + 0]];
+          std::get<1>(x.as<pair>()) = objects[references[index * 2 + 1]];
+        }
+      }
+
+      std::vector<object> roots (read_count(port));
+
+      for (auto& each : roots)
+      {
+        each = objects[reference()];
+      }
+
+      return roots;
+    }
+
+  public:
+    void dump_image(std::ostream& port)
+    {
+      write_image(port, "environment", {self().interaction_environment(), self().inlinables});
+    }
+
+    void dump_image(const std::string& path)
+    {
+      if (std::ofstream port {path, std::ios::binary}; port)
+      {
+        dump_image(port);
+      }
+      else
+      {
+        throw kernel_error {"failed to open file ", std::quoted(path)};
+      }
+    }
+
+    void restore_image(std::istream& port)
+    {
+      if (const auto roots = read_image(port, "environment"); std::size(roots) == 2)
+      {
+        std::get<1>(self()) = roots[0];
+        self().inlinables = roots[1];
+      }
+      else
+      {
+        throw kernel_error {"broken heap image"};
+      }
+    }
+
+    void restore_image(const std::string& path)
+    {
+      if (std::ifstream port {path, std::ios::binary}; port)
+      {
+        restore_image(port);
+      }
+      else
+      {
+        throw kernel_error {"failed to open file ", std::quoted(path)};
+      }
+    }
+
+    /* ========================================================================
+    * Program Image (Tree Shaking)
+    *
+    *   The image of a program (see "--build-executable") has the compiled
+    *   code of its toplevel forms, and only the part of the global
+    *   environment the code can reach. Code refers to a global variable by
+    *   its symbol (see LOAD_GLOBAL), so a binding is retained if its symbol
+    *   occurs in the code or in the value of a retained binding, and pruned
+    *   otherwise. A quoted symbol also retains the binding of its name, so
+    *   the walk never prunes too much.
+    *
+    *   Stubs reached by the walk are compiled first, so that the program
+    *   compiles nothing at startup. Macros are not retained, since the code
+    *   is expanded already. Bindings of layer 0 are recorded by name and cost
+    *   nothing, so they are always retained. Libraries reached by the walk
+    *   are written with their slots, so the program never loads their files.
+    *
+    *   The linker of a shared library is written only if a retained native
+    *   procedure is defined by it, so the other libraries are never opened.
+    *
+    *======================================================================= */
+  private:
+    static bool is_layer_0(const object& x)
+    {
+      return x and (x.is<special>() or (x.is<procedure>() and not native(x.as<procedure>())
+                                                           and not x.as<procedure>().template target<posix::symbol>()));
+    }
+
+    auto shake(const std::vector<object>& codes)
+    {
+      using label = typename SyntacticContinuation::label;
+      using jump_table = typename SyntacticContinuation::jump_table;
+
+      std::unordered_map<const pair*, object> bindings; // of each symbol, which assq finds
+
+      for (const object& each : self().interaction_environment())
+      {
+        bindings.emplace(car(each).get(), each);
+      }
+
+      std::unordered_set<const pair*> visited {nullptr}, retained;
+
+      for (std::vector<object> pending (std::rbegin(codes), std::rend(codes)); not std::empty(pending); )
+      {
+        const object x {pending.back()};
+
+        pending.pop_back();
+
+        if (not x or not visited.insert(x.get()).second)
+        {
+          continue;
+        }
+        else if (x.is<symbol>())
+        {
+          if (auto iter {bindings.find(x.get())}; iter != std::end(bindings))
+          {
+            auto& binding {cadr(iter->second).template as<cell>()};
+
+            if (const object value {binding.load()}; value and value.is<stub>())
+            {
+              self().materialize(binding, value);
+            }
+
+            if (const object value {binding.load()}; not value or not value.is<transformer>())
+            {
+              retained.insert(iter->second.get());
+              pending.push_back(value);
+            }
+          }
+        }
+        else if (x.is<transformer>()) // not the environment it closes
+        {
+          pending.push_back(car(x));
+        }
+        else if (x.is<library>())
+        {
+          std::copy(std::begin(x.as<library>().slots), std::end(x.as<library>().slots), std::back_inserter(pending));
+        }
+        else if (is_pair(x))
+        {
+          pending.push_back(cdr(x));
+          pending.push_back(car(x));
+        }
+        else if (x.is<cell>())
+        {
+          pending.push_back(x.as<cell>().load());
+        }
+        else if (x.is<label>())
+        {
+          pending.push_back(x.as<label>().code);
+        }
+        else if (x.is<jump_table>())
+        {
+          pending.push_back(x.as<jump_table>().otherwise);
+
+          for (const auto& [hash, branch] : x.as<jump_table>().branches)
+          {
+            pending.push_back(branch.first);
+            pending.push_back(branch.second);
+          }
+        }
+      }
+
+      /* ----------------------------------------------------------------------
+      * The pruned environment keeps the order of the original one, and the
+      * report lists the definitions of layer 1 and of the user, and the
+      * shared libraries of their native procedures.
+      *--------------------------------------------------------------------- */
+      std::vector<object> environment {};
+
+      std::vector<std::string> kept, pruned;
+
+      std::set<std::string> libraries, opened;
+
+      for (const object& each : self().interaction_environment())
+      {
+        const object value {cadr(each).template as<cell>().load()};
+
+        const auto* linked {value and value.is<procedure>() ? value.as<procedure>().template target<posix::symbol>() : nullptr};
+
+        if (value and value.is<posix::linker>())
+        {
+          libraries.insert(value.as<posix::linker>().path());
+        }
+        else if (linked)
+        {
+          libraries.insert(linked->linker.template as<posix::linker>().path());
+        }
+
+        if (is_layer_0(value))
+        {
+          environment.push_back(each);
+        }
+        else if (retained.count(each.get()))
+        {
+          environment.push_back(each);
+          kept.push_back(car(each).template as<const std::string>());
+
+          if (linked)
+          {
+            opened.insert(linked->linker.template as<posix::linker>().path());
+          }
+        }
+        else if (car(each).is<symbol>()) // others are never referred by code
+        {
+          pruned.push_back(car(each).template as<const std::string>());
+        }
+      }
+
+      auto report = [](const std::string& title, const auto& names)
+      {
+        std::cerr << "; shake\t\t; " << title << " (" << std::size(names) << ")";
+
+        for (const auto& name : names)
+        {
+          std::cerr << " " << name;
+        }
+
+        std::cerr << std::endl;
+      };
+
+      report("retained definitions", kept);
+      report("pruned definitions", pruned);
+
+      report("retained libraries", opened);
+
+      std::vector<std::string> unopened {};
+      std::set_difference(std::begin(libraries), std::end(libraries), std::begin(opened), std::end(opened), std::back_inserter(unopened));
+      report("pruned libraries", unopened);
+
+      return std::accumulate(std::rbegin(environment), std::rend(environment), unit, [](const auto& rest, const auto& each)
+             {
+               return cons(each, rest);
+             });
+    }
+
+  public:
+    void dump_program(std::ostream& port, const std::vector<object>& codes)
+    {
+      std::vector<object> roots (std::begin(codes), std::end(codes));
+
+      roots.insert(std::begin(roots), shake(codes));
+
+      write_image(port, "program", roots, true);
+    }
+
+    /* ------------------------------------------------------------------------
+    * Replace the global environment with the pruned one, and return the code
+    * of the toplevel forms of the program.
+    *----------------------------------------------------------------------- */
+    auto restore_program(std::istream& port)
+    {
+      auto roots = read_image(port, "program");
+
+      if (std::empty(roots))
+      {
+        throw kernel_error {"broken program image"};
+      }
+
+      std::get<1>(self()) = roots.front();
+      self().inlinables = unit;
+
+      roots.erase(std::begin(roots));
+
+      return roots;
+    }
+
+    /* ------------------------------------------------------------------------
+    * Compiled code of the toplevel forms of a file (see "load"), written in
+    * the same format. The key identifies the source and the configuration
+    * the code was compiled under.
+    *----------------------------------------------------------------------- */
+    void dump_code(std::ostream& port, const std::string& key, const std::vector<object>& codes)
+    {
+      write_image(port, key, codes);
+    }
+
+    auto restore_code(std::istream& port, const std::string& key)
+    {
+      return read_image(port, key);
+    }
+  };
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_IMAGE_HPP
@@ -10,25 +10,41 @@ namespace meevax::kernel
   #define MNEMONICS \
     (APPLY) \
     (APPLY_TAIL) \
+    (CALL_WITH_VALUES) \
+    (CASE) \
+    (CASE_TAIL) \
     (DEFINE) \
+    (ENTER) \
+    (GUARD) \
+    (INLINE) \
     (JOIN) \
+    (LEAVE) \
+    (LOAD_CELL) \
     (LOAD_GLOBAL) \
     (LOAD_LITERAL) \
     (LOAD_LOCAL) \
     (LOAD_LOCAL_VARIADIC) \
+    (LOAD_SLOT) \
+    (LOOP) \
+    (MAKE_CELLS) \
     (MAKE_CLOSURE) \
     (MAKE_CONTINUATION) \
     (MAKE_ENVIRONMENT) \
     (MAKE_SYNTACTIC_CONTINUATION) \
+    (OR) \
+    (OR_TAIL) \
     (POP) \
     (PUSH) \
     (RETURN) \
+    (RETURN_RECYCLE) \
     (SELECT) \
     (SELECT_TAIL) \
+    (SET_CELL) \
     (SET_GLOBAL) \
-    (SET_LOCAL) \
-    (SET_LOCAL_VARIADIC) \
-    (STOP)
+    (SPLICE) \
+    (STOP) \
+    (STORE_SLOT) \
+    (VALUES)
 
   enum class mnemonic
     : std::int8_t
@@ -0,0 +1,117 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_LIBRARY_HPP
+#define INCLUDED_MEEVAX_KERNEL_LIBRARY_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include <meevax/kernel/cell.hpp>
+#include <meevax/kernel/exception.hpp>
+#include <meevax/kernel/list.hpp>
+#include <meevax/kernel/numerical.hpp>
+#include <meevax/kernel/symbol.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Library is what "define-library" makes. The car is the name of the
+  * library, and each definition at the toplevel of its body has a slot (a
+  * cell) in it. Exported names are mapped to slots, so an importer shares
+  * the slots instead of copying their values.
+  *
+  * The compiler resolves a variable of a library body or of an importer to
+  * the slot once, and emits LOAD_SLOT or STORE_SLOT with the pair of the
+  * library and the index of the slot as operand. Neither importing nor
+  * referencing a binding of a library searches the global environment, so
+  * a program split into many libraries is compiled and run in time linear
+  * in its size.
+  *========================================================================= */
+  struct library
+    : public virtual pair
+  {
+    std::vector<object> names; // of slots
+
+    std::vector<object> slots; // cells
+
+    std::unordered_map<const pair*, std::size_t> indices; // of names
+
+    std::unordered_map<const pair*, std::size_t> exports; // external name to index
+
+    std::vector<object> exported; // external names, in the order exported
+
+    std::unordered_map<const pair*, object> imports; // name to (library . index)
+
+    template <typename... Ts>
+    explicit library(Ts&&... operands)
+      : pair {std::forward<decltype(operands)>(operands)...}
+    {}
+
+    /* ------------------------------------------------------------------------
+    * Return the index of the slot of the name, which is made if none.
+    *----------------------------------------------------------------------- */
+    auto slot(const object& name)
+    {
+      if (auto iter {indices.find(name.get())}; iter != std::end(indices))
+      {
+        return iter->second;
+      }
+      else
+      {
+        indices.emplace(name.get(), std::size(slots));
+        names.push_back(name);
+        slots.push_back(make<cell>(unbound));
+        return std::size(slots) - 1;
+      }
+    }
+
+    void export_(const object& name, const object& external)
+    {
+      if (exports.emplace(external.get(), slot(name)).second)
+      {
+        exported.push_back(external);
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * The key of a library name, e.g. "scheme/base" for (scheme base), which
+    * is also the path of the file defining it without the extension ".sld".
+    *----------------------------------------------------------------------- */
+    static auto key(const object& name)
+    {
+      std::string result {};
+
+      for (const object& each : name)
+      {
+        if (not std::empty(result))
+        {
+          result += "/";
+        }
+
+        if (each and each.is<symbol>())
+        {
+          result += each.as<const symbol>();
+        }
+        else if (each and each.is<real>() and each.as<const real>() == each.as<const real>().convert_to<long>())
+        {
+          result += std::to_string(each.as<const real>().convert_to<long>());
+        }
+        else
+        {
+          throw syntax_error {"library name must be a list of identifiers and exact integers, but given ", name};
+        }
+      }
+
+      return result;
+    }
+  };
+
+  std::ostream& operator<<(std::ostream& os, const library& library)
+  {
+    return os << highlight::syntax << "#("
+              << highlight::constructor << "library"
+              << attribute::normal << " " << std::get<0>(library)
+              << highlight::syntax << ")"
+              << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_LIBRARY_HPP
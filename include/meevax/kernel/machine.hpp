@@ -1,14 +1,28 @@
 #ifndef INCLUDED_MEEVAX_KERNEL_MACHINE_HPP
 #define INCLUDED_MEEVAX_KERNEL_MACHINE_HPP
 
+#include <algorithm> // std::find
+#include <cassert>
+#include <functional> // std::function
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <meevax/kernel/cell.hpp>
+#include <meevax/kernel/character.hpp>
 #include <meevax/kernel/closure.hpp>
 #include <meevax/kernel/continuation.hpp>
 #include <meevax/kernel/exception.hpp>
 #include <meevax/kernel/instruction.hpp>
+#include <meevax/kernel/library.hpp>
 #include <meevax/kernel/procedure.hpp>
 #include <meevax/kernel/special.hpp>
 #include <meevax/kernel/stack.hpp>
+#include <meevax/kernel/stub.hpp>
 #include <meevax/kernel/symbol.hpp> // object::is<symbol>()
+#include <meevax/kernel/transformer.hpp>
+#include <meevax/kernel/values.hpp>
 
 inline namespace ugly_macros
 {
@@ -18,8 +32,6 @@ inline namespace ugly_macros
     std::cerr << "; machine\t; " << "\x1B[?7l" << take(c, N) << "\x1B[?7h" << std::endl; \
   }
 
-  static std::size_t depth {0};
-
   #define DEBUG_COMPILE(...)                                                   \
   if (   static_cast<SyntacticContinuation&>(*this).verbose          == true_object  \
       or static_cast<SyntacticContinuation&>(*this).verbose_compiler == true_object) \
@@ -77,10 +89,265 @@ namespace meevax::kernel
           c, // control stack
           d; // dump stack (current-continuation)
 
+    std::size_t depth {0}; // nesting level of compiler (for debug output)
+
+    /* ------------------------------------------------------------------------
+    * Assignment conversion. While compiling the body of a lambda expression,
+    * the compiler records which variables of the lambda are assigned by set!
+    * and where they are referenced. Assigned variables are put into cells by
+    * MAKE_CELLS at the start of the body, and their references are rewritten
+    * to LOAD_CELL (see "closure_body"). Variables that are never assigned stay
+    * in the frame as they are, so only assigned ones pay for a cell.
+    *----------------------------------------------------------------------- */
+    struct scope
+    {
+      const object lexical_environment; // (<formals> . <enclosing environment>)
+
+      std::vector<std::pair<std::size_t, object>> references {};
+
+      std::map<std::size_t, std::size_t> assignments {}; // number of set! for each variable
+
+      bool captured {false}; // by a closure or a continuation made in the body
+
+      bool block {false}; // the frame of a binding construct (see "block")
+
+      /* ----------------------------------------------------------------------
+      * Loop compilation. A lambda expression assigned to a variable of the
+      * enclosing lambda expression (internal definition, letrec, named let)
+      * has the variable as "name". Its self tail calls, i.e. tail calls of
+      * the name directly in its body, are recorded in "self_calls", and then
+      * passed to the enclosing scope as "loops" with the code of the body. If
+      * the variable is not assigned again, each of them is rewritten to LOOP,
+      * which jumps to the body with the operands as the new frame, without
+      * loading the variable and without making a new frame.
+      *--------------------------------------------------------------------- */
+      object name {};
+
+      std::vector<std::pair<std::size_t, object>> self_calls {};
+
+      std::vector<std::tuple<std::size_t, object, object>> loops {};
+    };
+
+    std::vector<scope> scopes;
+
+    object assignee; // the name of the lambda expression to be compiled next
+
+    /* ------------------------------------------------------------------------
+    * Frame pool. A lambda expression whose body makes no closure and no
+    * continuation cannot let its frame escape by itself, so the compiler ends
+    * its body with RETURN_RECYCLE instead of RETURN (see "closure_body").
+    * RETURN_RECYCLE hands the frame over to this pool if nothing else refers
+    * to it (a callee may still have captured it by call/cc), and APPLY takes
+    * frames from the pool instead of allocating. APPLY_TAIL overwrites the
+    * frame of the caller in place under the same condition.
+    *----------------------------------------------------------------------- */
+    std::vector<object> frames;
+
+    static constexpr std::size_t frame_pool_size {1024};
+
+    std::size_t frames_recycled {0}, frames_reused {0}; // see "frame-statistics"
+
+    /* ------------------------------------------------------------------------
+    * Constant frame is a region of lexical environment that exists only at
+    * compile time. It binds the formals of an inlined lambda expression to
+    * the constant values of its operands (see "inline_application"). Variable
+    * references to it are compiled as literals, and it is not counted by the
+    * de Bruijn index because it has no runtime frame.
+    *----------------------------------------------------------------------- */
+    struct constant_frame
+      : public virtual pair
+    {
+      template <typename... Ts>
+      explicit constant_frame(Ts&&... operands)
+        : pair {std::forward<decltype(operands)>(operands)...}
+      {}
+    };
+
+    /* ------------------------------------------------------------------------
+    * The operand of LOOP. Since the body of a loop contains LOOP itself, the
+    * body is wrapped not to be printed recursively (e.g. by --trace).
+    *----------------------------------------------------------------------- */
+    struct label
+    {
+      const object code;
+
+      friend std::ostream& operator<<(std::ostream& os, const label& label)
+      {
+        return os << highlight::syntax << "#("
+                  << highlight::constructor << "label"
+                  << attribute::normal << highlight::comment << " #;" << &label << attribute::normal
+                  << highlight::syntax << ")"
+                  << attribute::normal;
+      }
+    };
+
+    /* ------------------------------------------------------------------------
+    * The operand of CASE. Each branch is keyed by a datum of the case clause,
+    * and found by the hash of the key followed by eqv? against the datum, so
+    * the dispatch on symbols, characters, booleans and integers takes the
+    * same time for any number of clauses. The other datums are hashed only by
+    * their types (eqv? of them never holds across types), so they are
+    * compared one by one as memv did.
+    *----------------------------------------------------------------------- */
+    struct jump_table
+    {
+      std::unordered_multimap<std::size_t, std::pair<const object, const object>> branches;
+
+      object otherwise;
+
+      static auto hash(const object& x) -> std::size_t
+      {
+        if (not x)
+        {
+          return 0;
+        }
+        else if (x.is<symbol>())
+        {
+          return std::hash<std::string> {}(x.as<const symbol>()) ^ typeid(symbol).hash_code();
+        }
+        else if (x.is<character>())
+        {
+          return std::hash<std::string> {}(x.as<const character>()) ^ typeid(character).hash_code();
+        }
+        else if (x.is<boolean>())
+        {
+          return std::hash<bool> {}(static_cast<bool>(x.as<const boolean>())) ^ typeid(boolean).hash_code();
+        }
+        else if (x.is<real>())
+        {
+          if (const auto& n {x.as<const real>()}; n == n.convert_to<long>())
+          {
+            return std::hash<long> {}(n.convert_to<long>());
+          }
+          else
+          {
+            return typeid(real).hash_code();
+          }
+        }
+        else
+        {
+          return x.type().hash_code();
+        }
+      }
+
+      static bool eqv(const object& x, const object& y)
+      {
+        return x == y or (x and y and x.equals(y));
+      }
+
+      void emplace(const object& datum, const object& branch)
+      {
+        const auto key {hash(datum)};
+
+        for (auto [iter, last] {branches.equal_range(key)}; iter != last; ++iter)
+        {
+          if (eqv(iter->second.first, datum))
+          {
+            return; // the first clause wins
+          }
+        }
+
+        branches.emplace(key, std::make_pair(datum, branch));
+      }
+
+      const object& select(const object& x) const
+      {
+        for (auto [iter, last] {branches.equal_range(hash(x))}; iter != last; ++iter)
+        {
+          if (eqv(iter->second.first, x))
+          {
+            return iter->second.second;
+          }
+        }
+
+        return otherwise;
+      }
+
+      friend std::ostream& operator<<(std::ostream& os, const jump_table& jump_table)
+      {
+        return os << highlight::syntax << "#("
+                  << highlight::constructor << "jump-table"
+                  << attribute::normal << highlight::comment << " #;" << &jump_table << attribute::normal
+                  << highlight::syntax << ")"
+                  << attribute::normal;
+      }
+    };
+
+    struct assignment_to_constant // not an error, see "inline_application"
+    {
+      const object frame;
+    };
+
+    /* ------------------------------------------------------------------------
+    * Native procedures without side effects, which the optimizer may apply to
+    * constant operands at compile time. Each entry has the minimum number of
+    * operands, and whether all operands must be real numbers. Constructors
+    * (e.g. cons) are not foldable, since each application must make a new
+    * object. The global variables of the folded procedures may be redefined
+    * or assigned later, so folded code is guarded by them (see "guard").
+    *----------------------------------------------------------------------- */
+    static inline const std::unordered_map<std::string, std::pair<std::size_t, bool>> foldables
+    {
+      {"addition",       {0, true }},
+      {"subtraction",    {1, true }},
+      {"multiplication", {0, true }},
+      {"division",       {1, true }},
+      {"less",           {2, true }},
+      {"less_equal",     {2, true }},
+      {"greater",        {2, true }},
+      {"greater_equal",  {2, true }},
+      {"equals",         {2, false}},
+      {"equivalent",     {2, false}},
+      {"pair_",          {0, false}},
+    };
+
+    /* ------------------------------------------------------------------------
+    * Small procedures defined at toplevel, which the optimizer may inline at
+    * their call sites (see "inline_global"). Each entry is the pair of the
+    * code shared by every closure of a lambda expression and the lambda
+    * expression itself, so a redefined or reassigned variable never matches
+    * the entry of its old value.
+    *----------------------------------------------------------------------- */
+    object inlinables;
+
+    std::vector<object> inlining; // codes being inlined, to stop recursion
+
+    static constexpr std::size_t inline_budget {24}; // atoms in the body
+
+    static constexpr std::size_t inline_depth {4};
+
+    transformer* expanding {nullptr}; // whose closure this machine is running
+
+    /* ------------------------------------------------------------------------
+    * Libraries (see library.hpp). While the body of a library is compiled,
+    * "defining" is the library, and its free variables are resolved to its
+    * own slots or to the slots imported into it. At toplevel, the variables
+    * imported by "import" are resolved to slots. The others are global.
+    *----------------------------------------------------------------------- */
+    object defining {unit};
+
+    std::unordered_map<const pair*, object> imports; // of the toplevel
+
   private: // CRTP Interfaces
-    decltype(auto) interaction_environment()
+    /* ------------------------------------------------------------------------
+    * While running the closure of a transformer, global variables are those
+    * of the environment the transformer closes.
+    *----------------------------------------------------------------------- */
+    stack& interaction_environment()
+    {
+      if (expanding)
+      {
+        return static_cast<stack&>(std::get<1>(*expanding));
+      }
+      else
+      {
+        return static_cast<SyntacticContinuation&>(*this).interaction_environment();
+      }
+    }
+
+    bool optimizing()
     {
-      return static_cast<SyntacticContinuation&>(*this).interaction_environment();
+      return static_cast<SyntacticContinuation&>(*this).optimize == true_object;
     }
 
     template <typename... Ts>
@@ -104,20 +371,81 @@ namespace meevax::kernel
     {
       // auto iter {export_(key, std::forward<decltype(operands)>(operands)...)};
       // interaction_environment().push(list(iter->first, iter->second));
-      interaction_environment().push(
-        list(key, std::forward<decltype(operands)>(operands)...));
+      /* ----------------------------------------------------------------------
+      * Workers of the thread pool may load the head of global environment
+      * concurrently (see syntactic_continuation::shared_environment).
+      *--------------------------------------------------------------------- */
+      std::atomic_store(
+        &static_cast<object&>(interaction_environment()),
+        cons(
+          list(key, make<cell>(std::forward<decltype(operands)>(operands)...)),
+          interaction_environment()));
 
       if (   static_cast<SyntacticContinuation&>(*this).verbose        == true_object
           or static_cast<SyntacticContinuation&>(*this).verbose_define == true_object)
       {
-        std::cerr << "; define\t; " << caar(interaction_environment()) << "\r\x1b[40C\x1b[K " << cadar(interaction_environment()) << std::endl;
+        std::cerr << "; define\t; " << caar(interaction_environment()) << "\r\x1b[40C\x1b[K " << cadar(interaction_environment()).template as<cell>().load() << std::endl;
       }
 
       return interaction_environment(); // temporary
     }
 
-    const object& lookup(const object& identifier,
-                         const object& environment)
+    /* ------------------------------------------------------------------------
+    * Return the operand of LOAD_SLOT and STORE_SLOT if the free variable is
+    * resolved to a slot, or unit if it is a global variable. The code of a
+    * stub and of a transformer is compiled in the global environment (see
+    * materialize), where no library is visible.
+    *----------------------------------------------------------------------- */
+    object resolve(const object& variable)
+    {
+      if (expanding or not variable or not variable.is<symbol>())
+      {
+        return unit;
+      }
+      else if (defining)
+      {
+        auto& library {defining.as<kernel::library>()};
+
+        if (auto iter {library.indices.find(variable.get())}; iter != std::end(library.indices))
+        {
+          return cons(defining, make<real>(iter->second));
+        }
+        else if (auto iter {library.imports.find(variable.get())}; iter != std::end(library.imports))
+        {
+          return iter->second;
+        }
+      }
+      else if (auto iter {imports.find(variable.get())}; iter != std::end(imports))
+      {
+        return iter->second;
+      }
+
+      return unit;
+    }
+
+    static decltype(auto) slot_of(const object& slot)
+    {
+      return car(slot).as<library>().slots[int {cdr(slot).as<real>()}].as<cell>();
+    }
+
+    /* ------------------------------------------------------------------------
+    * The value of the keyword of an application at compile time, to see if
+    * it is a special form or a macro.
+    *----------------------------------------------------------------------- */
+    object lookup_keyword(const object& keyword)
+    {
+      if (const object slot {resolve(keyword)}; slot)
+      {
+        return slot_of(slot).load();
+      }
+      else
+      {
+        return lookup(keyword, interaction_environment());
+      }
+    }
+
+    object lookup(const object& identifier,
+                  const object& environment)
     {
       if (not identifier or not environment)
       {
@@ -125,7 +453,7 @@ namespace meevax::kernel
       }
       else if (caar(environment) == identifier)
       {
-        return cadar(environment);
+        return cadar(environment).template as<cell>().load();
       }
       else
       {
@@ -133,6 +461,91 @@ namespace meevax::kernel
       }
     }
 
+    /* ------------------------------------------------------------------------
+    * Toplevel definition of a lambda expression, which may be bound to a stub
+    * instead of being compiled (see stub.hpp).
+    *----------------------------------------------------------------------- */
+    bool deferrable(const object& expression)
+    {
+      return expression
+         and expression.is<pair>()
+         and is_special(car(expression), unit, "define")
+         and cdr(expression) and cadr(expression) and cadr(expression).is<symbol>()
+         and cddr(expression)
+         and caddr(expression) and caddr(expression).is<pair>()
+         and is_special(car(caddr(expression)), unit, "lambda")
+         and not cdddr(expression);
+    }
+
+    void defer(const object& expression)
+    {
+      define(cadr(expression), make<stub>(caddr(expression), interaction_environment()));
+      ++stub::deferred;
+    }
+
+    /* ------------------------------------------------------------------------
+    * Compile the stub bound to the cell, and replace it with the closure. The
+    * lambda expression is compiled in the global environment of its
+    * definition, so it means the same as if compiled by the definition. Like
+    * the closure of a transformer (see expand), it is given to the compiler
+    * as the environment of a transformer.
+    *----------------------------------------------------------------------- */
+    object materialize(cell& binding, const object& x)
+    {
+      const std::lock_guard<std::recursive_mutex> lock {stub::mutex};
+
+      if (const object value {binding.load()}; value != x) // by another thread
+      {
+        return value;
+      }
+
+      transformer scope {unit, cdr(x)};
+
+      const auto previous {std::exchange(expanding, &scope)};
+
+      /* ----------------------------------------------------------------------
+      * A stub may be materialized while the body of another lambda expression
+      * is compiled (by inline_global). The lambda expression of the stub is
+      * not in that body, so it must not capture its frames (see "capture").
+      *--------------------------------------------------------------------- */
+      auto outer_scopes {std::exchange(scopes, {})};
+
+      object code {unit};
+
+      try
+      {
+        code = compile(car(x));
+
+        if (inlinable(car(x)))
+        {
+          inlinables = cons(cons(cadr(code), car(x)), inlinables);
+        }
+      }
+      catch (...)
+      {
+        expanding = previous;
+        scopes = std::move(outer_scopes);
+        throw;
+      }
+
+      expanding = previous;
+      scopes = std::move(outer_scopes);
+
+      const object value {make<closure>(cadr(code), unit)}; // (MAKE_CLOSURE body STOP)
+
+      binding.store(value);
+
+      ++stub::materialized;
+
+      if (   static_cast<SyntacticContinuation&>(*this).verbose        == true_object
+          or static_cast<SyntacticContinuation&>(*this).verbose_define == true_object)
+      {
+        std::cerr << "; define\t; materialize " << car(x) << std::endl;
+      }
+
+      return value;
+    }
+
     /* ------------------------------------------------------------------------
     *
     * <expression> = <identifier>
@@ -164,28 +577,54 @@ namespace meevax::kernel
         {
           if (de_bruijn_index index {expression, lexical_environment}; index)
           {
-            // XXX デバッグ用のトレースがないなら条件演算子でコンパクトにまとめたほうが良い
-            if (index.is_variadic())
+            if (index.is_constant())
             {
               DEBUG_COMPILE_DECISION(
-                "is <variable> references lexical variadic " << attribute::normal << index);
+                "is <variable> references constant " << attribute::normal << index.value());
 
               return
                 cons(
-                  make<instruction>(mnemonic::LOAD_LOCAL_VARIADIC), index,
+                  make<instruction>(mnemonic::LOAD_LITERAL), index.value(),
                   continuation);
             }
+            // XXX デバッグ用のトレースがないなら条件演算子でコンパクトにまとめたほうが良い
+            else if (index.is_variadic())
+            {
+              DEBUG_COMPILE_DECISION(
+                "is <variable> references lexical variadic " << attribute::normal << index);
+
+              return
+                reference(
+                  cons(
+                    make<instruction>(mnemonic::LOAD_LOCAL_VARIADIC), index,
+                    continuation),
+                  index,
+                  lexical_environment);
+            }
             else
             {
               DEBUG_COMPILE_DECISION(
                 "is <variable> references lexical " << attribute::normal << index);
 
               return
-                cons(
-                  make<instruction>(mnemonic::LOAD_LOCAL), index,
-                  continuation);
+                reference(
+                  cons(
+                    make<instruction>(mnemonic::LOAD_LOCAL), index,
+                    continuation),
+                  index,
+                  lexical_environment);
             }
           }
+          else if (const object slot {resolve(expression)}; slot)
+          {
+            DEBUG_COMPILE_DECISION(
+              "is <variable> references slot " << attribute::normal << cdr(slot) << " of " << car(slot));
+
+            return
+              cons(
+                make<instruction>(mnemonic::LOAD_SLOT), slot,
+                continuation);
+          }
           else
           {
             DEBUG_COMPILE_DECISION(
@@ -209,10 +648,7 @@ namespace meevax::kernel
       }
       else // is (application . arguments)
       {
-        if (object applicant {lookup(
-              car(expression), interaction_environment()
-            )};
-            not applicant)
+        if (object applicant {lookup_keyword(car(expression))}; not applicant)
         {
           COMPILER_WARNING(
             "compiler detected application of variable currently bounds "
@@ -235,7 +671,7 @@ namespace meevax::kernel
 
           return result;
         }
-        else if (applicant.is<SyntacticContinuation>()
+        else if (applicant.is<transformer>()
                  and not de_bruijn_index(car(expression), lexical_environment))
         {
           DEBUG_COMPILE(
@@ -249,8 +685,7 @@ namespace meevax::kernel
           //           << std::endl;
 
           const auto expanded {
-            applicant.as<SyntacticContinuation&>().expand(
-              expression)
+            expand(applicant.as<transformer&>(), expression)
           };
 
           DEBUG_MACROEXPAND(expanded << std::endl);
@@ -262,42 +697,188 @@ namespace meevax::kernel
           return result;
         }
 
-        DEBUG_COMPILE(
-          "(" << highlight::comment << "\t; is <procedure call>"
-              << attribute::normal << std::endl);
+        if (auto result {self_call(expression, lexical_environment, continuation, optimizable)}; result)
+        {
+          return result;
+        }
 
-        NEST_IN;
-        auto result {
-          operand(
-            cdr(expression),
-            lexical_environment,
-            compile(
-              car(expression),
-              lexical_environment,
-              cons(
-                make<instruction>(
-                  optimizable ? mnemonic::APPLY_TAIL : mnemonic::APPLY),
-                continuation)))
-        };
-        NEST_OUT;
-        return result;
+        if (optimizing())
+        {
+          object dependencies {unit};
+
+          if (const auto value {fold(expression, lexical_environment, dependencies)}; value != unbound)
+          {
+            DEBUG_COMPILE(
+              "(" << highlight::comment << "\t; is <constant expression> folded to "
+                  << attribute::normal << value << std::endl);
+            NEST_IN;
+            NEST_OUT;
+
+            return
+              guard(
+                dependencies,
+                cons(
+                  make<instruction>(mnemonic::LOAD_LITERAL), value,
+                  continuation),
+                [&]()
+                {
+                  return procedure_call(expression, lexical_environment, continuation, optimizable);
+                });
+          }
+          else if (auto inlined {inline_application(expression, lexical_environment, continuation, optimizable)}; inlined)
+          {
+            return inlined;
+          }
+          else if (auto inlined {inline_global(expression, lexical_environment, continuation, optimizable)}; inlined)
+          {
+            return inlined;
+          }
+        }
+
+        return procedure_call(expression, lexical_environment, continuation, optimizable);
       }
     }
 
-    decltype(auto) execute(const object& expression)
+    /*
+     * Compiles the application as is, without folding or inlining it. This is
+     * also the fallback of the folded application (see "guard").
+     */
+    object procedure_call(const object& expression,
+                          const object& lexical_environment,
+                          const object& continuation,
+                          const bool optimizable)
     {
-      c = expression;
-
-      if (   static_cast<SyntacticContinuation&>(*this).verbose         == true_object
-          or static_cast<SyntacticContinuation&>(*this).verbose_machine == true_object)
-      {
-        std::cerr << "; machine\t; " << c << std::endl;
-      }
+      DEBUG_COMPILE(
+        "(" << highlight::comment << "\t; is <procedure call>"
+            << attribute::normal << std::endl);
 
-      return execute();
+      NEST_IN;
+      auto result {
+        operand(
+          cdr(expression),
+          lexical_environment,
+          compile(
+            car(expression),
+            lexical_environment,
+            cons(
+              make<instruction>(
+                optimizable ? mnemonic::APPLY_TAIL : mnemonic::APPLY),
+              continuation)))
+      };
+      NEST_OUT;
+      return result;
     }
 
-    object execute()
+    /*
+     * Returns the only one of the operands, or the operands as multiple values
+     * (see "values").
+     */
+    static object make_values(const object& operands)
+    {
+      if (operands and not cdr(operands))
+      {
+        return car(operands);
+      }
+      else
+      {
+        return make<values>(operands, unit);
+      }
+    }
+
+    object make_frame(const object& operands, const object& enclosure)
+    {
+      if (frames.empty())
+      {
+        return cons(operands, enclosure);
+      }
+      else
+      {
+        object frame {std::move(frames.back())};
+        frames.pop_back();
+        ++frames_reused;
+        car(frame) = operands;
+        cdr(frame) = enclosure;
+        return frame;
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * Run the closure of the transformer on this machine with the macro use
+    * as its frame. The registers are restored afterwards, since the compiler
+    * may be called while this machine is running (e.g. by "evaluate"). The
+    * closure runs in a scope of its own, which has the renamings of this
+    * expansion only, so that the macro may be expanded by workers at once.
+    *----------------------------------------------------------------------- */
+    object expand(transformer& macro, const object& form)
+    {
+      if (const object expansion {macro.lookup(form)}; expansion)
+      {
+        return expansion;
+      }
+
+      const auto begin {std::chrono::steady_clock::now()};
+
+      transformer scope {std::get<0>(macro), std::get<1>(macro)};
+
+      scope.time_stamp = ++macro.time_stamp;
+
+      const auto registers {std::make_tuple(s, e, c, d, expanding)};
+
+      const auto restore = [&]()
+      {
+        std::tie(s, e, c, d, expanding) = registers;
+      };
+
+      const object& closure {std::get<0>(macro)};
+
+      s = unit;
+      e = cons(form, cdr(closure));
+      c = car(closure);
+      d = cons(
+            unit,                                    // s
+            unit,                                    // e
+            list(make<instruction>(mnemonic::STOP)), // c
+            unit);                                   // d
+
+      expanding = &scope;
+
+      object expansion {unit};
+
+      try
+      {
+        expansion = execute();
+      }
+      catch (...)
+      {
+        restore();
+        throw;
+      }
+
+      restore();
+
+      transformer::expansion_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - begin).count();
+
+      macro.memoize(form, expansion);
+
+      return expansion;
+    }
+
+    decltype(auto) execute(const object& expression)
+    {
+      c = expression;
+
+      if (   static_cast<SyntacticContinuation&>(*this).verbose         == true_object
+          or static_cast<SyntacticContinuation&>(*this).verbose_machine == true_object)
+      {
+        std::cerr << "; machine\t; " << c << std::endl;
+      }
+
+      return execute();
+    }
+
+    object execute()
     {
       // TODO
       // 上の引数付き版ではない、execute の直接呼び出しはおそらくマクロ展開にしか使われていないはずで、
@@ -337,6 +918,22 @@ namespace meevax::kernel
         c.pop(2);
         goto dispatch;
 
+      case mnemonic::LOAD_CELL: // S E (LOAD_CELL (i . j) . C) D => (value . S) E C D
+        TRACE(2);
+        {
+          homoiconic_iterator region {e};
+          std::advance(region, int {caadr(c).template as<real>()});
+
+          homoiconic_iterator position {*region};
+          std::advance(position, int {cdadr(c).template as<real>()});
+
+          const object& binding {position.is<cell>() ? position : *position};
+
+          s.push(binding.template as<cell>().load());
+        }
+        c.pop(2);
+        goto dispatch;
+
       case mnemonic::LOAD_LITERAL: // S E (LOAD_LITERAL constant . C) D => (constant . S) E C D
         TRACE(2);
         s.push(cadr(c));
@@ -345,13 +942,20 @@ namespace meevax::kernel
 
       case mnemonic::LOAD_GLOBAL: // S E (LOAD_GLOBAL symbol . C) D => (value . S) E C D
         TRACE(2);
-        if (auto value {
+        if (const auto& binding {
               assoc(
                 cadr(c),
                 interaction_environment())
-            }; value != unbound)
+            }; binding != unbound)
         {
-          s.push(value);
+          if (const object value {binding.template as<cell>().load()}; value and value.is<stub>())
+          {
+            s.push(materialize(binding.template as<cell>(), value));
+          }
+          else
+          {
+            s.push(value);
+          }
         }
         else
         {
@@ -369,16 +973,76 @@ namespace meevax::kernel
           * guaranteed not to collide with any symbol from the past to the
           * future. This behavior is defined for the hygienic-macro.
           *----------------------------------------------------------------- */
-          s.push(static_cast<SyntacticContinuation&>(*this).rename(cadr(c)));
+          if (expanding)
+          {
+            s.push(expanding->rename(cadr(c)));
+          }
+          else
+          {
+            s.push(static_cast<SyntacticContinuation&>(*this).rename(cadr(c)));
+          }
+        }
+        c.pop(2);
+        goto dispatch;
+
+      case mnemonic::LOAD_SLOT: // S E (LOAD_SLOT (library . index) . C) D => (value . S) E C D
+        TRACE(2);
+        if (const object value {slot_of(cadr(c)).load()}; value == unbound)
+        {
+          throw make<error>(caadr(c).template as<library>().names[int {cdadr(c).template as<real>()}], " is unbound");
+        }
+        else
+        {
+          s.push(value);
+        }
+        c.pop(2);
+        goto dispatch;
+
+      case mnemonic::MAKE_CELLS: // S (F . E) (MAKE_CELLS ((j . variadic) ...) . C) D => S (F' . E) C D
+        TRACE(2);
+        {
+          /* ------------------------------------------------------------------
+          * The frame F may be a list given by the caller (e.g. apply), so
+          * assigned variables are boxed into a copy of it instead of F itself.
+          * A variadic variable is always the last one, and its cell replaces
+          * the rest of the frame.
+          *----------------------------------------------------------------- */
+          object frame {unit}, rest {car(e)}, cells {cadr(c)};
+
+          auto* tail {&frame};
+
+          for (auto j {0}; cells; ++j)
+          {
+            if (int {caar(cells).template as<real>()} != j)
+            {
+              *tail = cons(car(rest), unit);
+            }
+            else if (cdar(cells) == true_object)
+            {
+              rest = make<cell>(rest);
+              break;
+            }
+            else
+            {
+              *tail = cons(make<cell>(car(rest)), unit);
+              cells = cdr(cells);
+            }
+
+            tail = &cdr(*tail);
+            rest = cdr(rest);
+          }
+
+          *tail = rest;
+
+          e = cons(frame, cdr(e));
         }
         c.pop(2);
         goto dispatch;
 
       case mnemonic::MAKE_ENVIRONMENT: // S E (MAKE_ENVIRONMENT code . C) => (enclosure . S) E C D
         TRACE(2);
-        // s.push(make<SyntacticContinuation>(cadr(c), interaction_environment()));
         s.push(
-          make<SyntacticContinuation>(
+          make<transformer>(
             make<closure>(cadr(c), e),
             interaction_environment()));
         c.pop(2);
@@ -401,7 +1065,7 @@ namespace meevax::kernel
 
       case mnemonic::MAKE_SYNTACTIC_CONTINUATION: // (closure . S) E (MAKE_SYNTACTIC_CONTINUATION . C) => (syntactic-continuation . S) E C D
         TRACE(2);
-        s = make<SyntacticContinuation>(
+        s = make<transformer>(
               car(s),
               interaction_environment())
           | cdr(s);
@@ -415,12 +1079,71 @@ namespace meevax::kernel
         s.pop(1);
         goto dispatch;
 
+      case mnemonic::OR: // (value . S) E (OR alternate . C) D => (value . S) E C D | S E alternate (C . D)
+        TRACE(2);
+        if (car(s) != false_object)
+        {
+          c.pop(2);
+        }
+        else
+        {
+          d.push(cddr(c));
+          c = cadr(c);
+          s.pop(1);
+        }
+        goto dispatch;
+
+      case mnemonic::OR_TAIL:
+        TRACE(2);
+        if (car(s) != false_object)
+        {
+          c.pop(2);
+        }
+        else
+        {
+          c = cadr(c);
+          s.pop(1);
+        }
+        goto dispatch;
+
       case mnemonic::SELECT_TAIL:
         TRACE(3);
         c = car(s) != false_object ? cadr(c) : caddr(c);
         s.pop(1);
         goto dispatch;
 
+      case mnemonic::VALUES: // (operands . S) E (VALUES . C) D => (values . S) E C D
+        TRACE(1);
+        s = make_values(car(s)) | cdr(s);
+        c.pop(1);
+        goto dispatch;
+
+      case mnemonic::CALL_WITH_VALUES: // (values . S) E (CALL_WITH_VALUES . C) D => (operands . S) E C D
+        TRACE(1);
+        if (car(s) and car(s).is<values>())
+        {
+          s = caar(s) | cdr(s);
+        }
+        else
+        {
+          s = list(car(s)) | cdr(s);
+        }
+        c.pop(1);
+        goto dispatch;
+
+      case mnemonic::CASE: // (key . S) E (CASE table . C) D => S E branch (C . D)
+        TRACE(2);
+        d.push(cddr(c));
+        c = cadr(c).template as<const jump_table>().select(car(s));
+        s.pop(1);
+        goto dispatch;
+
+      case mnemonic::CASE_TAIL:
+        TRACE(2);
+        c = cadr(c).template as<const jump_table>().select(car(s));
+        s.pop(1);
+        goto dispatch;
+
       case mnemonic::JOIN: // S E (JOIN . x) (C . D) => S E C D
         TRACE(1);
         c = car(d);
@@ -434,6 +1157,61 @@ namespace meevax::kernel
         c.pop(2);
         goto dispatch;
 
+      case mnemonic::INLINE: // (operands . S) E (INLINE symbol code fallback . C) D => S (operands . E) C D
+        TRACE(4);
+        /* --------------------------------------------------------------------
+        * The code C is the inlined body of the procedure which was the value
+        * of the global variable when the call was compiled. If the variable
+        * has been assigned or redefined since then, the call falls back to
+        * the ordinary application of the current value.
+        *------------------------------------------------------------------- */
+        if (const auto& binding {assq(cadr(c), interaction_environment())}; binding != false_object)
+        {
+          if (const object callee {cadr(binding).template as<cell>().load()};
+              callee and callee.is<closure>() and car(callee) == caddr(c))
+          {
+            e.push(car(s));
+            s.pop(1);
+            c = cddddr(c);
+            goto dispatch;
+          }
+        }
+        c = cadddr(c);
+        goto dispatch;
+
+      case mnemonic::GUARD: // S E (GUARD ((symbol . procedure) ...) fallback . C) D => S E C D
+        TRACE(3);
+        /* --------------------------------------------------------------------
+        * The code C was compiled by folding applications of the procedures
+        * which were the values of the global variables at compile time. If
+        * some of the variables has been assigned or redefined since then, the
+        * fallback compiled without folding is run instead.
+        *------------------------------------------------------------------- */
+        for (const auto& each : cadr(c))
+        {
+          if (const auto& binding {assq(car(each), interaction_environment())};
+              binding == false_object or cadr(binding).template as<cell>().load() != cdr(each))
+          {
+            c = caddr(c);
+            goto dispatch;
+          }
+        }
+        c = cdddr(c);
+        goto dispatch;
+
+      case mnemonic::ENTER: // (operands . S) E (ENTER . C) D => S (operands . E) C D
+        TRACE(1);
+        e = make_frame(car(s), e);
+        s.pop(1);
+        c.pop(1);
+        goto dispatch;
+
+      case mnemonic::LEAVE: // S (F . E) (LEAVE . C) D => S E C D
+        TRACE(1);
+        e.pop(1);
+        c.pop(1);
+        goto dispatch;
+
       case mnemonic::APPLY:
         TRACE(1);
 
@@ -446,7 +1224,7 @@ namespace meevax::kernel
         {
           d.push(cddr(s), e, cdr(c));
           c = car(callee);
-          e = cons(cadr(s), cdr(callee));
+          e = make_frame(cadr(s), cdr(callee));
           s = unit;
         }
         else if (callee.is<procedure>()) // (procedure operands . S) E (APPLY . C) D => (result . S) E C D
@@ -462,7 +1240,7 @@ namespace meevax::kernel
         // }
         else if (callee.is<continuation>()) // (continuation operands . S) E (APPLY . C) D
         {
-          s = cons(caadr(s), car(callee));
+          s = cons(make_values(cadr(s)), car(callee));
           e = cadr(callee);
           c = caddr(callee);
           d = cdddr(callee);
@@ -483,7 +1261,17 @@ namespace meevax::kernel
         else if (callee.is<closure>()) // (closure operands . S) E (APPLY . C) D
         {
           c = car(callee);
-          e = cons(cadr(s), cdr(callee));
+
+          if (e.use_count() == 1) // reuse the frame of the caller
+          {
+            car(e) = cadr(s);
+            cdr(e) = cdr(callee);
+          }
+          else
+          {
+            e = make_frame(cadr(s), cdr(callee));
+          }
+
           s = unit;
         }
         else if (callee.is<procedure>()) // (procedure operands . S) E (APPLY . C) D => (result . S) E C D
@@ -498,7 +1286,7 @@ namespace meevax::kernel
         // }
         else if (callee.is<continuation>()) // (continuation operands . S) E (APPLY . C) D
         {
-          s = cons(caadr(s), car(callee));
+          s = cons(make_values(cadr(s)), car(callee));
           e = cadr(callee);
           c = caddr(callee);
           d = cdddr(callee);
@@ -509,6 +1297,20 @@ namespace meevax::kernel
         }
         goto dispatch;
 
+      case mnemonic::LOOP: // (operands . S) (F . E) (LOOP label . C) D => () (operands . E) code D
+        TRACE(2);
+        if (e.use_count() == 1)
+        {
+          car(e) = car(s);
+        }
+        else
+        {
+          e = make_frame(car(s), cdr(e));
+        }
+        c = cadr(c).template as<label>().code;
+        s = unit;
+        goto dispatch;
+
       case mnemonic::RETURN: // (value . S) E (RETURN . C) (S' E' C' . D) => (value . S') E' C' D
         TRACE(1);
         s = cons(car(s), d.pop());
@@ -516,12 +1318,56 @@ namespace meevax::kernel
         c = d.pop();
         goto dispatch;
 
+      case mnemonic::RETURN_RECYCLE:
+        TRACE(1);
+        if (e.use_count() == 1 and std::size(frames) < frame_pool_size)
+        {
+          car(e) = unit;
+          cdr(e) = unit;
+          frames.push_back(std::move(e));
+          ++frames_recycled;
+        }
+        s = cons(car(s), d.pop());
+        e = d.pop();
+        c = d.pop();
+        goto dispatch;
+
       case mnemonic::PUSH:
         TRACE(1);
         s = car(s) | cadr(s) | cddr(s);
         c.pop(1);
         goto dispatch;
 
+      case mnemonic::SPLICE: // (list tail . S) E (SPLICE . C) D => (appended . S) E C D
+        TRACE(1);
+        if (not cadr(s)) // the last element shares the list as append does
+        {
+          s = car(s) | cddr(s);
+        }
+        else
+        {
+          object result {unit};
+
+          auto* position {&result};
+
+          for (auto rest {car(s)}; rest; rest = cdr(rest))
+          {
+            if (not rest.is<pair>())
+            {
+              throw evaluation_error {car(s), " is not a list to be spliced"};
+            }
+
+            *position = cons(car(rest), unit);
+            position = &cdr(*position);
+          }
+
+          *position = cadr(s);
+
+          s = result | cddr(s);
+        }
+        c.pop(1);
+        goto dispatch;
+
       case mnemonic::POP: // (var . S) E (POP . C) D => S E C D
         TRACE(1);
         s.pop(1);
@@ -530,14 +1376,16 @@ namespace meevax::kernel
 
       case mnemonic::SET_GLOBAL: // (value . S) E (SET_GLOBAL symbol . C) D => (value . S) E C D
         TRACE(2);
-        // TODO
-        // (1) There is no need to make copy if right hand side is unique.
-        // (2) There is no matter overwrite if left hand side is unique.
-        // (3) Should set with weak reference if right hand side is newer.
+        /* --------------------------------------------------------------------
+        * Assignment rebinds the variable to the object itself (eq? to the
+        * right hand side), not to a copy. Sharing is safe because no kernel
+        * object is modified in place. The only mutable locations are cells,
+        * which are replaced atomically. The value may also be unit, or an
+        * object which is not copy constructible (e.g. syntax).
+        *------------------------------------------------------------------- */
         if (const auto& key_value {assq(cadr(c), interaction_environment())}; key_value != false_object)
         {
-          // std::cerr << key_value << std::endl;
-          std::atomic_store(&cadr(key_value), car(s).copy());
+          cadr(key_value).template as<cell>().store(car(s));
         }
         else
         {
@@ -546,30 +1394,24 @@ namespace meevax::kernel
         c.pop(2);
         goto dispatch;
 
-      case mnemonic::SET_LOCAL: // (value . S) E (SET_LOCAL (i . j) . C) D => (value . S) E C D
+      case mnemonic::STORE_SLOT: // (value . S) E (STORE_SLOT (library . index) . C) D => (value . S) E C D
         TRACE(2);
-        {
-          homoiconic_iterator region {e};
-          std::advance(region, int {caadr(c).template as<real>()});
-
-          homoiconic_iterator position {*region};
-          std::advance(position, int {cdadr(c).template as<real>()});
-
-          std::atomic_store(&car(position), car(s));
-        }
+        slot_of(cadr(c)).store(car(s));
         c.pop(2);
         goto dispatch;
 
-      case mnemonic::SET_LOCAL_VARIADIC:
+      case mnemonic::SET_CELL: // (value . S) E (SET_CELL (i . j) . C) D => (value . S) E C D
         TRACE(2);
         {
           homoiconic_iterator region {e};
           std::advance(region, int {caadr(c).template as<real>()});
 
           homoiconic_iterator position {*region};
-          std::advance(position, int {cdadr(c).template as<real>()} - 1);
+          std::advance(position, int {cdadr(c).template as<real>()});
 
-          std::atomic_store(&cdr(position), car(s));
+          const object& binding {position.is<cell>() ? position : *position};
+
+          binding.template as<cell>().store(car(s));
         }
         c.pop(2);
         goto dispatch;
@@ -585,7 +1427,7 @@ namespace meevax::kernel
     class de_bruijn_index
       : public object // for runtime
     {
-      bool variadic;
+      bool variadic, constant;
 
     public:
       template <typename... Ts>
@@ -598,8 +1440,24 @@ namespace meevax::kernel
       {
         auto i {0};
 
+        constant = false;
+
         for (const auto& region : lexical_environment)
         {
+          if (region and region.is<constant_frame>())
+          {
+            for (homoiconic_iterator formals {car(region)}, values {cdr(region)}; formals; ++formals, ++values)
+            {
+              if (*formals == variable)
+              {
+                constant = true;
+                return cons(region, *values); // is not a runtime index
+              }
+            }
+
+            continue;
+          }
+
           auto j {0};
 
           for (homoiconic_iterator position {region}; position; ++position)
@@ -636,81 +1494,1505 @@ namespace meevax::kernel
       {
         return variadic;
       }
+
+      bool is_constant() const noexcept
+      {
+        return constant;
+      }
+
+      decltype(auto) frame() const
+      {
+        return car(*this);
+      }
+
+      decltype(auto) value() const
+      {
+        return cdr(*this);
+      }
     };
 
-  protected: // syntax
-    /*
-     * <quotation> = (quote <datum>)
-     */
-    object quotation(const object& expression,
-                     const object&,
-                     const object& continuation, bool)
+  protected: // assignment conversion
+    // Returns the scope of the lambda expression that binds the variable of the index.
+    scope* scope_of(const de_bruijn_index& index, const object& lexical_environment)
     {
-      DEBUG_COMPILE(
-        car(expression) << highlight::comment << "\t; is <datum>"
-                        << attribute::normal << std::endl
-      );
-      return
-        cons(
-          make<instruction>(mnemonic::LOAD_LITERAL), car(expression),
-          continuation);
-    }
+      auto region {lexical_environment};
 
-    /*
+      for (auto i {int {car(index).template as<real>()}}; ; region = cdr(region))
+      {
+        if (const auto& formals {car(region)}; formals and formals.is<constant_frame>())
+        {
+          continue;
+        }
+        else if (i-- == 0)
+        {
+          break;
+        }
+      }
+
+      for (auto iter {std::rbegin(scopes)}; iter != std::rend(scopes); ++iter)
+      {
+        if (iter->lexical_environment == region)
+        {
+          return &*iter;
+        }
+      }
+
+      return nullptr; // compiled outside of closure_body, enter and inline_global
+    }
+
+    // Strips constant frames, which have no runtime frame.
+    object runtime_environment(const object& lexical_environment)
+    {
+      if (lexical_environment and car(lexical_environment) and car(lexical_environment).is<constant_frame>())
+      {
+        return runtime_environment(cdr(lexical_environment));
+      }
+      else
+      {
+        return lexical_environment;
+      }
+    }
+
+    /*
+     * Compiles a self tail call (see "scope") as an ordinary tail call, and
+     * records where the callee is loaded so that it can be rewritten to LOOP.
+     */
+    object self_call(const object& expression,
+                     const object& lexical_environment,
+                     const object& continuation,
+                     const bool optimization)
+    {
+      if (not optimization or std::size(scopes) < 2)
+      {
+        return unit;
+      }
+
+      auto& self {scopes.back()};
+
+      if (not self.name
+          or car(expression) != self.name
+          or runtime_environment(lexical_environment) != self.lexical_environment
+          or runtime_environment(cdr(self.lexical_environment)) != std::rbegin(scopes)[1].lexical_environment)
+      {
+        return unit;
+      }
+
+      if (de_bruijn_index index {car(expression), lexical_environment};
+          not index or index.is_constant() or index.is_variadic() or int {car(index).template as<real>()} != 1)
+      {
+        return unit;
+      }
+      else
+      {
+        DEBUG_COMPILE(
+          "(" << highlight::comment << "\t; is <self tail call>"
+              << attribute::normal << std::endl);
+
+        NEST_IN;
+
+        const auto site {
+          compile(
+            car(expression),
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::APPLY_TAIL),
+              continuation))
+        };
+
+        self.self_calls.emplace_back(int {cdr(index).template as<real>()}, site);
+
+        auto result {operand(cdr(expression), lexical_environment, site)};
+
+        NEST_OUT;
+
+        return result;
+      }
+    }
+
+    /*
+     * Marks the frames of the lambda expression being compiled as escaping,
+     * including the frames of binding constructs in its body.
+     */
+    void capture()
+    {
+      for (auto iter {std::rbegin(scopes)}; iter != std::rend(scopes); ++iter)
+      {
+        iter->captured = true;
+
+        if (not iter->block)
+        {
+          break;
+        }
+      }
+    }
+
+    object reference(const object& code,
+                      const de_bruijn_index& index,
+                      const object& lexical_environment)
+    {
+      if (auto* const record {scope_of(index, lexical_environment)}; record)
+      {
+        record->references.emplace_back(int {cdr(index).template as<real>()}, code);
+      }
+
+      return code;
+    }
+
+    /*
+     * Compiles <body> of lambda expression (or syntactic closure), then puts
+     * the variables assigned in it into cells.
+     */
+    object closure_body(const object& expression,
+                        const object& lexical_environment)
+    {
+      const auto formals {car(expression)};
+
+      const auto extended_environment {cons(formals, lexical_environment)};
+
+      scopes.push_back({extended_environment});
+
+      const struct pop_scope
+      {
+        std::vector<scope>& scopes;
+
+        ~pop_scope()
+        {
+          scopes.pop_back();
+        }
+      } pop {scopes};
+
+      scopes.back().name = std::exchange(assignee, unit);
+
+      const auto terminal {list(make<instruction>(mnemonic::RETURN))};
+
+      auto code {
+        body(
+          cdr(expression),
+          extended_environment,
+          terminal, // continuation of body (finally, must be return)
+          true)
+      };
+
+      if (not scopes.back().captured)
+      {
+        car(terminal) = make<instruction>(mnemonic::RETURN_RECYCLE);
+      }
+
+      return convert(formals, code);
+    }
+
+    /*
+     * Puts the variables of the current scope assigned in the code into
+     * cells, and rewrites the self tail calls of the procedures bound to them
+     * into loops (see "scope").
+     */
+    object convert(const object& formals, object code)
+    {
+      auto& record {scopes.back()};
+
+      if (not record.assignments.empty())
+      {
+        for (const auto& [j, each] : record.references)
+        {
+          if (record.assignments.count(j))
+          {
+            car(each) = make<instruction>(mnemonic::LOAD_CELL);
+          }
+        }
+
+        object cells {unit};
+
+        for (auto iter {std::rbegin(record.assignments)}; iter != std::rend(record.assignments); ++iter)
+        {
+          homoiconic_iterator position {formals};
+          std::advance(position, iter->first);
+
+          cells = cons(
+                    cons(
+                      make<real>(iter->first),
+                      position.is<pair>() ? false_object : true_object),
+                    cells);
+        }
+
+        DEBUG_COMPILE(formals << highlight::comment << "\t; has cells " << attribute::normal << cells << std::endl);
+
+        code = cons(make<instruction>(mnemonic::MAKE_CELLS), cells, code);
+      }
+
+      for (const auto& [j, site, loop] : record.loops)
+      {
+        if (const auto iter {record.assignments.find(j)}; iter != std::end(record.assignments) and iter->second == 1)
+        {
+          car(site) = make<instruction>(mnemonic::LOOP);
+          cadr(site) = make<label>(loop); // NOTE: makes a cycle, as a recursive closure does
+        }
+      }
+
+      for (const auto& [j, site] : record.self_calls)
+      {
+        std::rbegin(scopes)[1].loops.emplace_back(j, site, code);
+      }
+
+      return code;
+    }
+
+  protected: // optimization
+    bool is_special(const object& keyword, const object& lexical_environment, const std::string& name)
+    {
+      if (de_bruijn_index(keyword, lexical_environment))
+      {
+        return false;
+      }
+      else
+      {
+        const object applicant {lookup_keyword(keyword)};
+        return applicant and applicant.is<special>() and applicant.as<special>().name == name;
+      }
+    }
+
+    /*
+     * Returns the value of the expression if it is a constant, or a
+     * combination of foldable procedure and constants. Otherwise returns
+     * unbound. Since macros are not expanded here, a macro use is never
+     * regarded as a constant. The global variables of the applied procedures
+     * are added to dependencies with their values, which the folded code
+     * must be guarded by (see "guard").
+     */
+    object fold(const object& expression, const object& lexical_environment, object& dependencies)
+    {
+      if (not expression)
+      {
+        return unit;
+      }
+      else if (not expression.is<pair>())
+      {
+        if (not expression.is<symbol>())
+        {
+          return expression; // self-evaluating
+        }
+        else if (de_bruijn_index index {expression, lexical_environment}; index.is_constant())
+        {
+          return index.value();
+        }
+        else
+        {
+          return unbound;
+        }
+      }
+      else if (is_special(car(expression), lexical_environment, "quote"))
+      {
+        return cadr(expression);
+      }
+      else if (de_bruijn_index(car(expression), lexical_environment) or resolve(car(expression)))
+      {
+        return unbound;
+      }
+      else if (const object callee {lookup(car(expression), interaction_environment())}; callee and callee.is<procedure>())
+      {
+        if (auto iter {foldables.find(callee.as<procedure>().name)}; iter != std::end(foldables))
+        {
+          const auto& [minimum, reals] {iter->second};
+
+          object operands {unit};
+
+          for (const auto& each : cdr(expression))
+          {
+            if (const object value {fold(each, lexical_environment, dependencies)}; value == unbound or (reals and not (value and value.is<real>())))
+            {
+              return unbound;
+            }
+            else
+            {
+              operands = append(operands, list(value));
+            }
+          }
+
+          if (static_cast<std::size_t>(length(operands)) < minimum)
+          {
+            return unbound;
+          }
+          else try
+          {
+            const auto value {std::invoke(callee.as<procedure>(), operands)};
+
+            if (assq(car(expression), dependencies) == false_object)
+            {
+              dependencies = cons(cons(car(expression), callee), dependencies);
+            }
+
+            return value;
+          }
+          catch (...) // leave the error to runtime
+          {
+            return unbound;
+          }
+        }
+      }
+
+      return unbound;
+    }
+
+    // Whether the expression may be removed if its value is unused.
+    bool discardable(const object& expression, const object& lexical_environment, object& dependencies)
+    {
+      return not expression
+          or not expression.is<pair>()
+          or is_special(car(expression), lexical_environment, "lambda")
+          or fold(expression, lexical_environment, dependencies) != unbound;
+    }
+
+    /*
+     * Runs the code compiled by the result of folding if every global variable
+     * of dependencies still has the procedure it had at compile time, and the
+     * code made by fallback otherwise (see GUARD). Like INLINE, the code is
+     * never stale after the variable is redefined or assigned. Fallback is
+     * called only if there are dependencies.
+     */
+    template <typename Fallback>
+    object guard(const object& dependencies, const object& code, Fallback&& fallback)
+    {
+      if (not dependencies)
+      {
+        return code;
+      }
+      else
+      {
+        return cons(make<instruction>(mnemonic::GUARD), dependencies, fallback(), code);
+      }
+    }
+
+    /*
+     * Inlines ((lambda <formals> <body>) <operand>*) if every operand is a
+     * constant. The formals are bound to the operands by a constant frame, and
+     * the body is compiled as a sequence in place of the application, so no
+     * closure and no frame are made at runtime. Returns unit if the
+     * expression cannot be inlined, e.g. the body assigns one of the formals
+     * by set! or has internal definitions. The operands folded by global
+     * procedures are guarded by them (see "guard").
+     */
+    object inline_application(const object& expression,
+                              const object& lexical_environment,
+                              const object& continuation,
+                              const bool optimization)
+    {
+      const auto& callee {car(expression)};
+
+      if (not callee
+          or not callee.is<pair>()
+          or not is_special(car(callee), lexical_environment, "lambda")
+          or not cddr(callee) // empty body
+          or length(cadr(callee)) != length(cdr(expression)))
+      {
+        return unit;
+      }
+
+      for (const auto& each : cddr(callee))
+      {
+        if (each and each.is<pair>() and car(each) == intern("define"))
+        {
+          return unit; // internal definitions
+        }
+      }
+
+      object values {unit}, dependencies {unit};
+
+      for (homoiconic_iterator formals {cadr(callee)}, operands {cdr(expression)}; formals; ++formals, ++operands)
+      {
+        if (not formals.is<pair>() or not *formals or not (*formals).is<symbol>())
+        {
+          return unit; // variadic
+        }
+        else if (const object value {fold(*operands, lexical_environment, dependencies)}; value == unbound)
+        {
+          return unit;
+        }
+        else
+        {
+          values = append(values, list(value));
+        }
+      }
+
+      const auto frame {make<constant_frame>(cadr(callee), values)};
+
+      DEBUG_COMPILE(
+        "(" << highlight::comment << "\t; is <procedure call> inlined with "
+            << attribute::normal << cdr(frame) << std::endl);
+
+      NEST_IN;
+
+      try
+      {
+        auto result {
+          sequence(
+            cddr(callee),
+            cons(frame, lexical_environment),
+            continuation,
+            optimization)
+        };
+
+        NEST_OUT;
+
+        return
+          guard(dependencies, result, [&]()
+          {
+            return procedure_call(expression, lexical_environment, continuation, optimization);
+          });
+      }
+      catch (const assignment_to_constant& exception)
+      {
+        if (exception.frame != frame)
+        {
+          throw;
+        }
+      }
+      catch (const syntax_error_about_internal_define&)
+      {}
+
+      NEST_OUT;
+
+      return unit;
+    }
+
+    /*
+     * Whether the lambda expression defined at toplevel may be inlined by
+     * "inline_global". Its formals must be a proper list, and its body must be
+     * small and must not make closures, assign or define variables.
+     */
+    bool inlinable(const object& expression)
+    {
+      if (not expression
+          or not expression.is<pair>()
+          or not is_special(car(expression), unit, "lambda")
+          or not cdr(expression)
+          or not cddr(expression))
+      {
+        return false;
+      }
+
+      for (homoiconic_iterator formals {cadr(expression)}; formals; ++formals)
+      {
+        if (not formals.is<pair>() or not *formals or not (*formals).is<symbol>())
+        {
+          return false;
+        }
+      }
+
+      std::size_t size {0};
+
+      const object lambda_ {intern("lambda")}, set_ {intern("set!")}, define_ {intern("define")};
+
+      const std::function<bool (const object&)> small = [&](const object& x)
+      {
+        if (not x)
+        {
+          return true;
+        }
+        else if (x.is<pair>())
+        {
+          return small(car(x)) and small(cdr(x));
+        }
+        else
+        {
+          return ++size <= inline_budget and x != lambda_ and x != set_ and x != define_;
+        }
+      };
+
+      return small(cddr(expression));
+    }
+
+    /*
+     * Inlines the application of a global variable whose value is a closure
+     * of an inlinable lambda expression. The operands are evaluated as usual,
+     * then INLINE checks that the variable still has the same procedure, and
+     * binds the formals to the operands by pushing a frame without a closure,
+     * a dump and RETURN. The body is compiled at the call site, so it is not
+     * inlined if some variable of the body is shadowed by a local variable or
+     * a variable of a library (see resolve) there. Like the frame of a binding
+     * construct, the frame has its own scope, so the formals assigned by a
+     * macro in the body are put into cells (see "convert").
+     */
+    object inline_global(const object& expression,
+                         const object& lexical_environment,
+                         const object& continuation,
+                         const bool optimization)
+    {
+      const auto& name {car(expression)};
+
+      if (not name or not name.is<symbol>() or de_bruijn_index(name, lexical_environment) or resolve(name))
+      {
+        return unit;
+      }
+
+      object callee {lookup(name, interaction_environment())};
+
+      if (callee and callee.is<stub>())
+      {
+        callee = materialize(assoc(name, interaction_environment()).template as<cell>(), callee);
+      }
+
+      if (not callee or not callee.is<closure>())
+      {
+        return unit;
+      }
+
+      const object code {car(callee)};
+
+      const object source {assq(code, inlinables)};
+
+      if (source == false_object
+          or inline_depth <= std::size(inlining)
+          or std::find(std::begin(inlining), std::end(inlining), code) != std::end(inlining))
+      {
+        return unit;
+      }
+
+      const auto& formals {cadr(cdr(source))};
+
+      if (length(formals) != length(cdr(expression)))
+      {
+        return unit;
+      }
+
+      const std::function<bool (const object&)> shadowed = [&](const object& x)
+      {
+        if (not x)
+        {
+          return false;
+        }
+        else if (x.is<pair>())
+        {
+          return shadowed(car(x)) or shadowed(cdr(x));
+        }
+        else if (x.is<symbol>())
+        {
+          for (const auto& formal : formals)
+          {
+            if (formal == x)
+            {
+              return false;
+            }
+          }
+
+          return static_cast<bool>(de_bruijn_index(x, lexical_environment)) or
+                 static_cast<bool>(resolve(x));
+        }
+        else
+        {
+          return false;
+        }
+      };
+
+      if (shadowed(cddr(cdr(source))))
+      {
+        return unit;
+      }
+
+      DEBUG_COMPILE(
+        "(" << highlight::comment << "\t; is <procedure call> inlined "
+            << attribute::normal << cdr(source) << std::endl);
+
+      NEST_IN;
+
+      inlining.push_back(code);
+
+      const struct pop_inlining
+      {
+        std::vector<object>& inlining;
+
+        ~pop_inlining()
+        {
+          inlining.pop_back();
+        }
+      } pop {inlining};
+
+      /* ----------------------------------------------------------------------
+      * In tail position, the frame is left on E because RETURN (or the tail
+      * call in the body) discards it anyway.
+      *--------------------------------------------------------------------- */
+      object body {unit};
+
+      {
+        const auto extended_environment {cons(formals, lexical_environment)};
+
+        scopes.push_back({extended_environment});
+
+        scopes.back().block = true; // the frame pushed by INLINE, as by ENTER
+
+        const struct pop_scope
+        {
+          std::vector<scope>& scopes;
+
+          ~pop_scope()
+          {
+            scopes.pop_back();
+          }
+        } popping {scopes};
+
+        body = convert(
+                 formals,
+                 sequence(
+                   cddr(cdr(source)),
+                   extended_environment,
+                   optimization ? continuation : cons(make<instruction>(mnemonic::LEAVE), continuation),
+                   optimization));
+      }
+
+      auto result {
+        operand(
+          cdr(expression),
+          lexical_environment,
+          cons(
+            make<instruction>(mnemonic::INLINE), name, code,
+            compile(
+              name,
+              lexical_environment,
+              cons(
+                make<instruction>(
+                  optimization ? mnemonic::APPLY_TAIL : mnemonic::APPLY),
+                continuation)),
+            body))
+      };
+
+      NEST_OUT;
+
+      return result;
+    }
+
+  protected: // syntax
+    /*
+     * <quotation> = (quote <datum>)
+     */
+    object quotation(const object& expression,
+                     const object&,
+                     const object& continuation, bool)
+    {
+      DEBUG_COMPILE(
+        car(expression) << highlight::comment << "\t; is <datum>"
+                        << attribute::normal << std::endl
+      );
+      return
+        cons(
+          make<instruction>(mnemonic::LOAD_LITERAL), car(expression),
+          continuation);
+    }
+
+    /*
+     * <quasiquotation> = (quasiquote <qq template>)
+     *
+     * The template is expanded at compile time. A sub-template without
+     * unquote of the current depth is loaded as a literal shared by every
+     * evaluation, and the others are constructed by PUSH (cons) and SPLICE
+     * (append) from the tail to the head.
+     */
+    object quasiquotation(const object& expression,
+                          const object& lexical_environment,
+                          const object& continuation, bool = false)
+    {
+      DEBUG_COMPILE(
+        car(expression) << highlight::comment << "\t; is <qq template>"
+                        << attribute::normal << std::endl);
+
+      return template_(car(expression), 0, lexical_environment, continuation);
+    }
+
+    bool constant_template(const object& x, std::size_t depth)
+    {
+      if (not x or not x.is<pair>())
+      {
+        return true;
+      }
+      else if (car(x) == intern("quasiquote"))
+      {
+        return constant_template(cdr(x), depth + 1);
+      }
+      else if (car(x) == intern("unquote") or car(x) == intern("unquote-splicing"))
+      {
+        return 0 < depth and constant_template(cdr(x), depth - 1);
+      }
+      else
+      {
+        return constant_template(car(x), depth) and constant_template(cdr(x), depth);
+      }
+    }
+
+    object template_(const object& x,
+                     std::size_t depth,
+                     const object& lexical_environment,
+                     const object& continuation)
+    {
+      if (constant_template(x, depth))
+      {
+        return
+          cons(
+            make<instruction>(mnemonic::LOAD_LITERAL), x,
+            continuation);
+      }
+      else if (const auto& keyword {car(x)}; keyword == intern("quasiquote")
+                                          or keyword == intern("unquote")
+                                          or keyword == intern("unquote-splicing"))
+      {
+        if (keyword == intern("quasiquote"))
+        {
+          ++depth;
+        }
+        else if (0 < depth)
+        {
+          --depth;
+        }
+        else if (keyword == intern("unquote") and cdr(x) and not cddr(x))
+        {
+          return compile(cadr(x), lexical_environment, continuation);
+        }
+        else
+        {
+          throw syntax_error {"illegal ", keyword};
+        }
+
+        return
+          template_(
+            cdr(x),
+            depth,
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::LOAD_LITERAL), keyword,
+              make<instruction>(mnemonic::PUSH),
+              continuation));
+      }
+      else if (const auto& head {car(x)}; depth == 0
+                                          and head
+                                          and head.is<pair>()
+                                          and (car(head) == intern("unquote") or car(head) == intern("unquote-splicing")))
+      {
+        /* --------------------------------------------------------------------
+        * (unquote <expression>*) and (unquote-splicing <expression>*) as an
+        * element of list. Each expression is consed or appended to the tail
+        * from the last one.
+        *------------------------------------------------------------------- */
+        const auto constructor {
+          make<instruction>(car(head) == intern("unquote") ? mnemonic::PUSH : mnemonic::SPLICE)
+        };
+
+        auto code {continuation};
+
+        for (const auto& each : cdr(head))
+        {
+          code = compile(each, lexical_environment, cons(constructor, code));
+        }
+
+        return template_(cdr(x), depth, lexical_environment, code);
+      }
+      else
+      {
+        return
+          template_(
+            cdr(x),
+            depth,
+            lexical_environment,
+            template_(
+              car(x),
+              depth,
+              lexical_environment,
+              cons(
+                make<instruction>(mnemonic::PUSH),
+                continuation)));
+      }
+    }
+
+    /*
      * <sequence> = <command>* <expression>
      *
-     * <command> = <expression (the return value will be ignored)>
+     * <command> = <expression (the return value will be ignored)>
+     */
+    object sequence(const object& expression,
+                    const object& lexical_environment,
+                    const object& continuation,
+                    const bool optimization = false)
+    {
+      if (object dependencies {unit}; cdr(expression) and optimizing() and discardable(car(expression), lexical_environment, dependencies))
+      {
+        const auto rest {
+          sequence(
+            cdr(expression), // the value of head expression is unused
+            lexical_environment,
+            continuation,
+            optimization)
+        };
+
+        return
+          guard(dependencies, rest, [&]()
+          {
+            return
+              compile(
+                car(expression),
+                lexical_environment,
+                cons(
+                  make<instruction>(mnemonic::POP),
+                  rest));
+          });
+      }
+      else if (not cdr(expression)) // is tail sequence
+      {
+        return
+          compile(
+            car(expression),
+            lexical_environment,
+            continuation,
+            optimization);
+      }
+      else
+      {
+        return
+          compile(
+            car(expression), // head expression
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::POP), // pop result of head expression
+              sequence(
+                cdr(expression), // rest expressions
+                lexical_environment,
+                continuation)));
+      }
+    }
+
+    /*
+     * <program> = <command or definition>+
+     *
+     * <command or definition> = <command>
+     *                         | <definition>
+     *                         | (begin <command or definition>+)
+     *
+     * <command> = <expression (the return value will be ignored)>
+     */
+    object program(const object& expression,
+                   const object& lexical_environment,
+                   const object& continuation, const bool = false) try
+    {
+      if (not cdr(expression)) // is tail sequence
+      {
+        return
+          compile(
+            car(expression),
+            lexical_environment,
+            continuation,
+            true);
+      }
+      else
+      {
+        return
+          compile(
+            car(expression),
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::POP),
+              sequence(
+                cdr(expression),
+                lexical_environment,
+                continuation)));
+      }
+    }
+    catch (const error&) // XXX <definition> backtrack
+    {
+      // (environment (<unknown>)
+      //   <car expression>
+      //   <cdr expression>
+      //   )
+      //
+      // <car expression> = (<caar expression> <cadar expression> <caddar expression>)
+      //                  = (#(syntax define) <identifier> <expression>)
+
+      auto definition {
+        compile(
+          cddar(expression) ? caddar(expression) : undefined,
+          lexical_environment,
+          list(
+            make<instruction>(mnemonic::DEFINE), cadar(expression)))
+      };
+
+      NEST_OUT;
+
+      return
+        append(
+          definition,
+          cdr(expression)
+            ? program(
+                cdr(expression),
+                lexical_environment,
+                continuation)
+            : continuation);
+    }
+
+    /*
+     * <definition> = (define <identifier> <expression>)
+     */
+    object definition(const object& expression,
+                      const object& lexical_environment,
+                      const object& continuation,
+                      const bool = false)
+    {
+      if (not lexical_environment and defining and not expanding and car(expression).is<symbol>())
+      {
+        DEBUG_COMPILE(
+          car(expression) << highlight::comment << "\t; is <variable> of "
+                          << attribute::normal << defining << std::endl);
+
+        return
+          compile(
+            cdr(expression) ? cadr(expression) : undefined,
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::STORE_SLOT),
+              cons(defining, make<real>(defining.as<library>().slot(car(expression)))),
+              continuation));
+      }
+      else if (not lexical_environment)
+      {
+        DEBUG_COMPILE(
+          car(expression) << highlight::comment << "\t; is <variable>"
+                          << attribute::normal << std::endl);
+
+        imports.erase(car(expression).get()); // shadowed by the global variable
+
+        const auto code {
+          compile(
+            cdr(expression) ? cadr(expression) : undefined,
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::DEFINE), car(expression),
+              continuation))
+        };
+
+        if (cdr(expression) and inlinable(cadr(expression)))
+        {
+          inlinables = cons(cons(cadr(code), cadr(expression)), inlinables);
+        }
+
+        return code;
+      }
+      else
+      {
+        throw syntax_error_about_internal_define {
+          "definition cannot appear in this context"
+        };
+      }
+    }
+
+    /*
+     * <body> := <definition>* <sequence>
+     */
+    object body(const object& expression,
+                const object& lexical_environment,
+                const object& continuation,
+                const bool optimization = false) // try
+    {
+      /************************************************************************
+      * The expression may have following form.
+      *
+      * (lambda (...)
+      *   <definition or command> ;= <car expression>
+      *   <definition or sequence> ;= <cdr expression>
+      *   )
+      ************************************************************************/
+      if (not cdr(expression)) // is tail sequence
+      {
+        /**********************************************************************
+        * The expression may have following form.
+        * If definition appears in <car expression>, it is an syntax error.
+        *
+        * (lambda (...)
+        *   <expression> ;= <car expression>
+        *   )
+        **********************************************************************/
+        return
+          compile(
+            car(expression),
+            lexical_environment,
+            continuation,
+            optimization); // tail-call optimization
+      }
+      else if (not car(expression))
+      {
+        /**********************************************************************
+        * The expression may have following form.
+        * If definition appears in <cdr expression>, it is an syntax error.
+        *
+        * (lambda (...)
+        *   () ;= <car expression>
+        *   <sequence> ;= <cdr expression>)
+        **********************************************************************/
+        return
+          sequence(
+            cdr(expression),
+            lexical_environment,
+            continuation);
+      }
+      else if (not car(expression).is<pair>()
+               or caar(expression) != intern("define"))
+      {
+        /**********************************************************************
+        * The expression may have following form.
+        *
+        * (lambda (...)
+        *   <non-definition expression> ;= <car expression>
+        *   <sequence> ;= <cdr expression>)
+        **********************************************************************/
+        return
+          compile(
+            car(expression), // <non-definition expression>
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::POP), // remove result of expression
+              sequence(
+                cdr(expression),
+                lexical_environment,
+                continuation)));
+      }
+      else // 5.3.2 Internal Definitions
+      {
+        /**********************************************************************
+         * The expression may have following form.
+         * If definition appears in <car expression> or <cdr expression>, it is
+         * an syntax error.
+         *
+         * (lambda (...)
+         *   (define <variable> <initialization>) ;= <car expression>
+         *   <sequence> ;= <cdr expression>)
+         *********************************************************************/
+        // std::cerr << "; letrec*\t; <expression> := " << expression << std::endl;
+
+        // <bindings> := ( (<variable> <initialization>) ...)
+        object bindings {list(
+          cdar(expression) // (<variable> <initialization>)
+        )};
+
+        // <body> of letrec* := <sequence>+
+        object body {};
+
+        /**********************************************************************
+        * Collect <definition>s from <cdr expression>.
+        * It is guaranteed that <cdr expression> is not unit from first
+        * conditional of this member function.
+        *
+        * The <cdr expression> may have following form.
+        *
+        * ( <expression 1>
+        *   <expression 2>
+        *   ...
+        *   <expression N> )
+        *
+        **********************************************************************/
+        for (homoiconic_iterator each {cdr(expression)}; each; ++each)
+        {
+          if (not car(each) or // unit (TODO? syntax-error)
+              not car(each).is<pair>() or // <identifier or literal>
+              caar(each) != intern("define"))
+          {
+            body = each;
+
+            // std::cerr << "; letrec*\t; <bindings> := " << bindings << std::endl;
+            //
+            // std::cerr << "; letrec*\t; <body> := " << body << std::endl;
+          }
+          else
+          {
+            bindings = append(bindings, list(cdar(each)));
+          }
+        }
+
+        return
+          recursive_block(
+            bindings,
+            body,
+            lexical_environment,
+            continuation,
+            optimization);
+      }
+    }
+
+    /*
+     * Binds the variables of <bindings> ((<variable> <init>) ...) to
+     * unspecified values by a block, assigns each <init> to them in order,
+     * then compiles <body> (the semantics of letrec*).
+     */
+    object recursive_block(const object& bindings,
+                           const object& body,
+                           const object& lexical_environment,
+                           const object& continuation,
+                           const bool optimization)
+    {
+      const object formals {map(car, bindings)};
+
+      const object operands {make_list(length(formals), undefined)};
+
+      const object assignments {map(
+        [this](auto&& each)
+        {
+          return intern("set!") | each;
+        },
+        bindings
+      )};
+
+      return
+        block(
+          formals,
+          operands,
+          lexical_environment,
+          continuation,
+          optimization,
+          [&](const object& extended_environment, const object& continuation, const bool optimization)
+          {
+            return
+              this->body(
+                append(assignments, body),
+                extended_environment,
+                continuation,
+                optimization);
+          });
+    }
+
+    /*
+     * <operand> = <expression>
+     */
+    /*
+     * Compiles a body with a frame which binds the formals to the values of
+     * the operands, e.g. <body> of let. The operands are evaluated as usual,
+     * then ENTER pushes them onto E as a frame without making a closure and a
+     * dump, and LEAVE pops it after the body. If the body is in tail position
+     * of a lambda expression, the frame is left on E because RETURN (or the
+     * tail call in the body) discards it anyway. The frame is a scope as the
+     * frame of a lambda expression is, so its assigned variables are put into
+     * cells.
+     */
+    object block(const object& formals,
+                 const object& operands,
+                 const object& lexical_environment,
+                 const object& continuation,
+                 const bool optimization,
+                 const std::function<object (const object&, const object&, bool)>& compile_body)
+    {
+      return
+        operand(
+          operands,
+          lexical_environment,
+          enter(formals, lexical_environment, continuation, optimization, compile_body));
+    }
+
+    /*
+     * Compiles ENTER and the body of a block, which takes the frame from the
+     * top of S. The code which pushes the frame is up to the caller (see
+     * "block" and "receive").
+     */
+    object enter(const object& formals,
+                 const object& lexical_environment,
+                 const object& continuation,
+                 const bool optimization,
+                 const std::function<object (const object&, const object&, bool)>& compile_body)
+    {
+      const auto tail {
+        optimization and car(continuation).template as<instruction>().code == mnemonic::RETURN
+      };
+
+      object code {unit};
+
+      {
+        const auto extended_environment {cons(formals, lexical_environment)};
+
+        scopes.push_back({extended_environment});
+
+        scopes.back().block = true;
+
+        const struct pop_scope
+        {
+          std::vector<scope>& scopes;
+
+          ~pop_scope()
+          {
+            scopes.pop_back();
+          }
+        } pop {scopes}; // before compiling the operands, which are out of the scope
+
+        code = convert(
+                 formals,
+                 compile_body(
+                   extended_environment,
+                   tail ? continuation : cons(make<instruction>(mnemonic::LEAVE), continuation),
+                   tail));
+      }
+
+      return cons(make<instruction>(mnemonic::ENTER), code);
+    }
+
+    object operand(const object& expression,
+                   const object& lexical_environment,
+                   const object& continuation, bool = false)
+    {
+      if (expression && expression.is<pair>())
+      {
+        return
+          operand(
+            cdr(expression),
+            lexical_environment,
+            compile(
+              car(expression),
+              lexical_environment,
+              cons(
+                make<instruction>(mnemonic::PUSH),
+                continuation)));
+      }
+      else
+      {
+        return
+          compile(
+            expression,
+            lexical_environment,
+            continuation);
+      }
+    }
+
+    /**
+     * <conditional> = (if <test> <consequent> <alternate>)
+     **/
+    object conditional(const object& expression,
+                       const object& lexical_environment,
+                       const object& continuation,
+                       const bool optimization = false)
+    {
+      DEBUG_COMPILE(
+        car(expression) << highlight::comment << "\t; is <test>"
+                        << attribute::normal << std::endl);
+
+      if (object dependencies {unit}; optimizing())
+      {
+        const auto fallback = [&]()
+        {
+          return selection(expression, lexical_environment, continuation, optimization);
+        };
+
+        if (const auto test {fold(car(expression), lexical_environment, dependencies)}; test == unbound)
+        {
+          // the test is not a constant
+        }
+        else if (test != false_object)
+        {
+          return guard(dependencies, compile(cadr(expression), lexical_environment, continuation, optimization), fallback);
+        }
+        else if (cddr(expression))
+        {
+          return guard(dependencies, compile(caddr(expression), lexical_environment, continuation, optimization), fallback);
+        }
+        else
+        {
+          return
+            guard(
+              dependencies,
+              cons(
+                make<instruction>(mnemonic::LOAD_LITERAL), undefined,
+                continuation),
+              fallback);
+        }
+      }
+
+      return selection(expression, lexical_environment, continuation, optimization);
+    }
+
+    /*
+     * Compiles the conditional as is, selecting the branch at runtime. This is
+     * also the fallback of the conditional whose test is folded (see "guard").
+     */
+    object selection(const object& expression,
+                     const object& lexical_environment,
+                     const object& continuation,
+                     const bool optimization)
+    {
+      /* ----------------------------------------------------------------------
+      * In tail position, both branches end with the continuation itself (the
+      * RETURN of the body), so that closure_body rewrites every exit of the
+      * body to RETURN_RECYCLE at once.
+      *--------------------------------------------------------------------- */
+      if (optimization)
+      {
+        const auto consequent {
+          compile(
+            cadr(expression),
+            lexical_environment,
+            continuation,
+            true)
+        };
+
+        const auto alternate {
+          cddr(expression)
+            ? compile(
+                caddr(expression),
+                lexical_environment,
+                continuation,
+                true)
+            : cons(
+                make<instruction>(mnemonic::LOAD_LITERAL), undefined,
+                continuation)
+        };
+
+        return
+          compile(
+            car(expression), // <test>
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::SELECT_TAIL),
+              consequent,
+              alternate,
+              cdr(continuation)));
+      }
+      else
+      {
+        const auto consequent {
+          compile(
+            cadr(expression),
+            lexical_environment,
+            list(make<instruction>(mnemonic::JOIN)))
+        };
+
+        const auto alternate {
+          cddr(expression)
+            ? compile(
+                caddr(expression),
+                lexical_environment,
+                list(make<instruction>(mnemonic::JOIN)))
+            : list(
+                make<instruction>(mnemonic::LOAD_LITERAL), undefined,
+                make<instruction>(mnemonic::JOIN))
+        };
+
+        return
+          compile(
+            car(expression), // <test>
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::SELECT),
+              consequent,
+              alternate,
+              continuation));
+      }
+    }
+
+    /*
+     * <one-armed conditional> = (when <test> <expression>+)
+     *                         | (unless <test> <expression>+)
+     */
+    object one_armed_conditional(const object& expression,
+                                 const object& lexical_environment,
+                                 const object& continuation,
+                                 const bool optimization,
+                                 const bool negation)
+    {
+      DEBUG_COMPILE(
+        car(expression) << highlight::comment << "\t; is <test>"
+                        << attribute::normal << std::endl);
+
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {negation ? "unless" : "when"};
+      }
+
+      const auto consequent {
+        sequence(
+          cdr(expression),
+          lexical_environment,
+          optimization ? continuation : list(make<instruction>(mnemonic::JOIN)),
+          optimization)
+      };
+
+      const auto alternate {
+        cons(
+          make<instruction>(mnemonic::LOAD_LITERAL), undefined,
+          optimization ? continuation : list(make<instruction>(mnemonic::JOIN)))
+      };
+
+      return
+        compile(
+          car(expression), // <test>
+          lexical_environment,
+          cons(
+            make<instruction>(optimization ? mnemonic::SELECT_TAIL : mnemonic::SELECT),
+            negation ? alternate : consequent,
+            negation ? consequent : alternate,
+            continuation));
+    }
+
+    object when(const object& expression,
+                const object& lexical_environment,
+                const object& continuation,
+                const bool optimization = false)
+    {
+      return one_armed_conditional(expression, lexical_environment, continuation, optimization, false);
+    }
+
+    object unless(const object& expression,
+                  const object& lexical_environment,
+                  const object& continuation,
+                  const bool optimization = false)
+    {
+      return one_armed_conditional(expression, lexical_environment, continuation, optimization, true);
+    }
+
+    /*
+     * <conjunction> = (and <test>*)
+     *
+     * Each test jumps to the next one by SELECT, or to #false otherwise.
      */
-    object sequence(const object& expression,
-                    const object& lexical_environment,
-                    const object& continuation,
-                    const bool optimization = false)
+    object conjunction(const object& expression,
+                       const object& lexical_environment,
+                       const object& continuation,
+                       const bool optimization = false)
     {
-      if (not cdr(expression)) // is tail sequence
+      if (not expression)
       {
         return
-          compile(
-            car(expression),
-            lexical_environment,
-            continuation,
-            optimization);
+          cons(
+            make<instruction>(mnemonic::LOAD_LITERAL), true_object,
+            continuation);
+      }
+      else if (not cdr(expression))
+      {
+        return compile(car(expression), lexical_environment, continuation, optimization);
       }
       else
       {
+        const auto join {
+          optimization ? continuation : list(make<instruction>(mnemonic::JOIN))
+        };
+
         return
           compile(
-            car(expression), // head expression
+            car(expression),
             lexical_environment,
             cons(
-              make<instruction>(mnemonic::POP), // pop result of head expression
-              sequence(
-                cdr(expression), // rest expressions
-                lexical_environment,
-                continuation)));
+              make<instruction>(optimization ? mnemonic::SELECT_TAIL : mnemonic::SELECT),
+              conjunction(cdr(expression), lexical_environment, join, optimization),
+              cons(make<instruction>(mnemonic::LOAD_LITERAL), false_object, join),
+              continuation));
       }
     }
 
     /*
-     * <program> = <command or definition>+
+     * <disjunction> = (or <test>*)
      *
-     * <command or definition> = <command>
-     *                         | <definition>
-     *                         | (begin <command or definition>+)
-     *
-     * <command> = <expression (the return value will be ignored)>
+     * The value of each test is left on S as the result by OR if it is not
+     * #false, and then the rest tests are skipped. So no temporary variable is
+     * needed.
      */
-    object program(const object& expression,
-                   const object& lexical_environment,
-                   const object& continuation, const bool = false) try
+    object disjunction(const object& expression,
+                       const object& lexical_environment,
+                       const object& continuation,
+                       const bool optimization = false)
     {
-      if (not cdr(expression)) // is tail sequence
+      if (not expression)
       {
         return
-          compile(
-            car(expression),
-            lexical_environment,
-            continuation,
-            true);
+          cons(
+            make<instruction>(mnemonic::LOAD_LITERAL), false_object,
+            continuation);
+      }
+      else if (not cdr(expression))
+      {
+        return compile(car(expression), lexical_environment, continuation, optimization);
       }
       else
       {
@@ -719,334 +3001,602 @@ namespace meevax::kernel
             car(expression),
             lexical_environment,
             cons(
-              make<instruction>(mnemonic::POP),
-              sequence(
+              make<instruction>(optimization ? mnemonic::OR_TAIL : mnemonic::OR),
+              disjunction(
                 cdr(expression),
                 lexical_environment,
-                continuation)));
+                optimization ? continuation : list(make<instruction>(mnemonic::JOIN)),
+                optimization),
+              continuation));
       }
     }
-    catch (const error&) // XXX <definition> backtrack
-    {
-      // (environment (<unknown>)
-      //   <car expression>
-      //   <cdr expression>
-      //   )
-      //
-      // <car expression> = (<caar expression> <cadar expression> <caddar expression>)
-      //                  = (#(syntax define) <identifier> <expression>)
-
-      auto definition {
-        compile(
-          cddar(expression) ? caddar(expression) : undefined,
-          lexical_environment,
-          list(
-            make<instruction>(mnemonic::DEFINE), cadar(expression)))
-      };
-
-      NEST_OUT;
-
-      return
-        append(
-          definition,
-          cdr(expression)
-            ? program(
-                cdr(expression),
-                lexical_environment,
-                continuation)
-            : continuation);
-    }
 
     /*
-     * <definition> = (define <identifier> <expression>)
+     * <cond> = (cond <cond clause>+)
+     *        | (cond <cond clause>* (else <sequence>))
+     *
+     * <cond clause> = (<test> <sequence>)
+     *               | (<test>)
+     *               | (<test> => <recipient>)
      */
-    object definition(const object& expression,
-                      const object& lexical_environment,
-                      const object& continuation,
-                      const bool = false)
+    object cond(const object& expression,
+                const object& lexical_environment,
+                const object& continuation,
+                const bool optimization = false)
     {
-      if (not lexical_environment)
+      if (not expression)
       {
-        DEBUG_COMPILE(
-          car(expression) << highlight::comment << "\t; is <variable>"
-                          << attribute::normal << std::endl);
-
         return
-          compile(
-            cdr(expression) ? cadr(expression) : undefined,
-            lexical_environment,
-            cons(
-              make<instruction>(mnemonic::DEFINE), car(expression),
-              continuation));
+          cons(
+            make<instruction>(mnemonic::LOAD_LITERAL), undefined,
+            continuation);
       }
-      else
+
+      const auto& clause {car(expression)};
+
+      const auto join {
+        optimization ? continuation : list(make<instruction>(mnemonic::JOIN))
+      };
+
+      const auto keyword = [&](const object& x, const std::string& name)
       {
-        throw syntax_error_about_internal_define {
-          "definition cannot appear in this context"
-        };
+        return x == intern(name) and not de_bruijn_index(x, lexical_environment);
+      };
+
+      if (not clause or not clause.is<pair>())
+      {
+        throw syntax_error {"cond"};
       }
-    }
+      else if (keyword(car(clause), "else"))
+      {
+        if (cdr(expression))
+        {
+          throw syntax_error {"cond: else clause must be the last one"};
+        }
 
-    /*
-     * <body> := <definition>* <sequence>
-     */
-    object body(const object& expression,
-                const object& lexical_environment,
-                const object& continuation, bool = false) // try
-    {
-      /************************************************************************
-      * The expression may have following form.
-      *
-      * (lambda (...)
-      *   <definition or command> ;= <car expression>
-      *   <definition or sequence> ;= <cdr expression>
-      *   )
-      ************************************************************************/
-      if (not cdr(expression)) // is tail sequence
+        return sequence(cdr(clause), lexical_environment, continuation, optimization);
+      }
+      else if (not cdr(clause))
       {
-        /**********************************************************************
-        * The expression may have following form.
-        * If definition appears in <car expression>, it is an syntax error.
-        *
-        * (lambda (...)
-        *   <expression> ;= <car expression>
-        *   )
-        **********************************************************************/
         return
           compile(
-            car(expression),
+            car(clause),
             lexical_environment,
-            continuation,
-            true); // tail-call optimization
+            cons(
+              make<instruction>(optimization ? mnemonic::OR_TAIL : mnemonic::OR),
+              cond(cdr(expression), lexical_environment, join, optimization),
+              continuation));
       }
-      else if (not car(expression))
+      else if (keyword(cadr(clause), "=>"))
       {
-        /**********************************************************************
-        * The expression may have following form.
-        * If definition appears in <cdr expression>, it is an syntax error.
-        *
-        * (lambda (...)
-        *   () ;= <car expression>
-        *   <sequence> ;= <cdr expression>)
-        **********************************************************************/
+        /* --------------------------------------------------------------------
+        * The value of the test is bound to an uninterned symbol by a block,
+        * which no other expression refers to.
+        *------------------------------------------------------------------- */
+        const object value {make<symbol>("value")};
+
         return
-          sequence(
-            cdr(expression),
+          block(
+            list(value),
+            list(car(clause)),
             lexical_environment,
-            continuation);
+            continuation,
+            optimization,
+            [&](const object& extended_environment, const object& continuation, const bool optimization)
+            {
+              const auto join {
+                optimization ? continuation : list(make<instruction>(mnemonic::JOIN))
+              };
+
+              return
+                compile(
+                  value,
+                  extended_environment,
+                  cons(
+                    make<instruction>(optimization ? mnemonic::SELECT_TAIL : mnemonic::SELECT),
+                    compile(list(caddr(clause), value), extended_environment, join, optimization),
+                    cond(cdr(expression), extended_environment, join, optimization),
+                    continuation));
+            });
       }
-      else if (not car(expression).is<pair>()
-               or caar(expression) != intern("define"))
+      else
       {
-        /**********************************************************************
-        * The expression may have following form.
-        *
-        * (lambda (...)
-        *   <non-definition expression> ;= <car expression>
-        *   <sequence> ;= <cdr expression>)
-        **********************************************************************/
         return
           compile(
-            car(expression), // <non-definition expression>
+            car(clause),
             lexical_environment,
             cons(
-              make<instruction>(mnemonic::POP), // remove result of expression
-              sequence(
-                cdr(expression),
-                lexical_environment,
-                continuation)));
+              make<instruction>(optimization ? mnemonic::SELECT_TAIL : mnemonic::SELECT),
+              sequence(cdr(clause), lexical_environment, join, optimization),
+              cond(cdr(expression), lexical_environment, join, optimization),
+              continuation));
       }
-      else // 5.3.2 Internal Definitions
+    }
+
+    /*
+     * <case> = (case <expression> <case clause>+)
+     *        | (case <expression> <case clause>* (else <sequence>))
+     *        | (case <expression> <case clause>* (else => <recipient>))
+     *
+     * <case clause> = ((<datum>*) <sequence>)
+     *               | ((<datum>*) => <recipient>)
+     *
+     * The clauses are compiled into a jump table, so the key is evaluated
+     * once and compared with no datum but the ones of the same hash. The key
+     * is bound to an uninterned symbol only if some clause has a recipient
+     * or no expression (which results in the key).
+     */
+    object case_(const object& expression,
+                 const object& lexical_environment,
+                 const object& continuation,
+                 const bool optimization = false)
+    {
+      if (not expression)
       {
-        /**********************************************************************
-         * The expression may have following form.
-         * If definition appears in <car expression> or <cdr expression>, it is
-         * an syntax error.
-         *
-         * (lambda (...)
-         *   (define <variable> <initialization>) ;= <car expression>
-         *   <sequence> ;= <cdr expression>)
-         *********************************************************************/
-        // std::cerr << "; letrec*\t; <expression> := " << expression << std::endl;
+        throw syntax_error {"case"};
+      }
 
-        // <bindings> := ( (<variable> <initialization>) ...)
-        object bindings {list(
-          cdar(expression) // (<variable> <initialization>)
-        )};
+      const auto keyword = [&](const object& x, const std::string& name)
+      {
+        return x == intern(name) and not de_bruijn_index(x, lexical_environment);
+      };
 
-        // <body> of letrec* := <sequence>+
-        object body {};
+      const auto recipient = [&](const object& clause)
+      {
+        return cdr(clause) and keyword(cadr(clause), "=>");
+      };
 
-        /**********************************************************************
-        * Collect <definition>s from <cdr expression>.
-        * It is guaranteed that <cdr expression> is not unit from first
-        * conditional of this member function.
-        *
-        * The <cdr expression> may have following form.
-        *
-        * ( <expression 1>
-        *   <expression 2>
-        *   ...
-        *   <expression N> )
-        *
-        **********************************************************************/
-        for (homoiconic_iterator each {cdr(expression)}; each; ++each)
+      const auto refers_key = [&](const object& clause)
+      {
+        return clause and clause.is<pair>() and (not cdr(clause) or recipient(clause));
+      };
+
+      const object value {
+        std::any_of(begin(cdr(expression)), end(cdr(expression)), refers_key) ? make<symbol>("value") : unit
+      };
+
+      const auto compile_clauses = [&](const object& lexical_environment, const object& continuation, const bool optimization)
+      {
+        const auto join {
+          optimization ? continuation : list(make<instruction>(mnemonic::JOIN))
+        };
+
+        const auto branch = [&](const object& clause)
         {
-          if (not car(each) or // unit (TODO? syntax-error)
-              not car(each).is<pair>() or // <identifier or literal>
-              caar(each) != intern("define"))
+          if (not cdr(clause)) // the value of the key, as the test of cond
           {
-            body = each;
+            return compile(value, lexical_environment, join, optimization);
+          }
+          else if (recipient(clause))
+          {
+            return compile(list(caddr(clause), value), lexical_environment, join, optimization);
+          }
+          else
+          {
+            return sequence(cdr(clause), lexical_environment, join, optimization);
+          }
+        };
 
-            // std::cerr << "; letrec*\t; <bindings> := " << bindings << std::endl;
-            //
-            // std::cerr << "; letrec*\t; <body> := " << body << std::endl;
+        const auto table {make<jump_table>()};
+
+        auto& branches {table.template as<jump_table>()};
+
+        branches.otherwise = cons(make<instruction>(mnemonic::LOAD_LITERAL), undefined, join);
+
+        for (auto clauses {cdr(expression)}; clauses; clauses = cdr(clauses))
+        {
+          if (const auto& clause {car(clauses)}; not clause or not clause.is<pair>())
+          {
+            throw syntax_error {"case"};
+          }
+          else if (keyword(car(clause), "else"))
+          {
+            if (cdr(clauses))
+            {
+              throw syntax_error {"case: else clause must be the last one"};
+            }
+
+            branches.otherwise = branch(clause);
           }
           else
           {
-            bindings = append(bindings, list(cdar(each)));
+            const auto code {branch(clause)};
+
+            for (const auto& datum : car(clause))
+            {
+              branches.emplace(datum, code);
+            }
           }
         }
 
-        const object formals {map(car, bindings)};
-        // std::cerr << "; letrec*\t; <formals> := " << formals << std::endl;
+        return
+          compile(
+            value ? value : car(expression),
+            lexical_environment,
+            cons(
+              make<instruction>(optimization ? mnemonic::CASE_TAIL : mnemonic::CASE),
+              table,
+              continuation));
+      };
+
+      if (value)
+      {
+        return
+          block(
+            list(value),
+            list(car(expression)),
+            lexical_environment,
+            continuation,
+            optimization,
+            compile_clauses);
+      }
+      else
+      {
+        return compile_clauses(lexical_environment, continuation, optimization);
+      }
+    }
 
-        const object operands {make_list(length(formals), undefined)};
-        // std::cerr << "; letrec*\t; <operands> := " << operands << std::endl;
+    /*
+     * <let> = (let (<binding spec>*) <body>)
+     *       | (let <variable> (<binding spec>*) <body>)
+     *
+     * <binding spec> = (<variable> <expression>)
+     *
+     * An unnamed let is compiled as a block. A named let binds the variable to
+     * the procedure by a recursive block, so that the self tail calls of the
+     * procedure are compiled to loops.
+     */
+    object let(const object& expression,
+               const object& lexical_environment,
+               const object& continuation,
+               const bool optimization = false)
+    {
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {"The let syntax is defined as the form (let <bindings> <body>) but lacks <body>."};
+      }
+      else if (car(expression) and car(expression).is<symbol>()) // named let
+      {
+        const auto& name {car(expression)};
 
-        const object assignments {map(
-          [this](auto&& each)
-          {
-            return intern("set!") | each;
-          },
-          bindings
-        )};
-        // std::cerr << "; letrec*\t; <assignments> := " << assignments << std::endl;
+        if (not cddr(expression))
+        {
+          throw syntax_error {"The let syntax is defined as the form (let <variable> <bindings> <body>) but lacks <body>."};
+        }
 
-        const object result {
-          cons(
+        return
+          recursive_block(
+            list(
+              list(
+                name,
+                cons(intern("lambda"), map(car, cadr(expression)), cddr(expression)))),
+            list(
+              cons(name, map(cadr, cadr(expression)))),
+            lexical_environment,
+            continuation,
+            optimization);
+      }
+      else
+      {
+        if (optimizing())
+        {
+          const object application {
             cons(
-              intern("lambda"),
-              formals,
-              append(assignments, body)),
-            operands)
-        };
-        // std::cerr << "; letrec*\t; result := " << result << std::endl;
+              cons(intern("lambda"), map(car, car(expression)), cdr(expression)),
+              map(cadr, car(expression)))
+          };
+
+          if (auto inlined {inline_application(application, lexical_environment, continuation, optimization)}; inlined)
+          {
+            return inlined;
+          }
+        }
 
         return
-          compile(
-            result,
+          block(
+            map(car, car(expression)),
+            map(cadr, car(expression)),
             lexical_environment,
-            continuation);
+            continuation,
+            optimization,
+            [&](const object& extended_environment, const object& continuation, const bool optimization)
+            {
+              return body(cdr(expression), extended_environment, continuation, optimization);
+            });
       }
     }
 
     /*
-     * <operand> = <expression>
+     * <let*> = (let* (<binding spec>*) <body>)
+     *
+     * Each binding spec is compiled as a block of one variable, nested in the
+     * block of the previous one.
      */
-    object operand(const object& expression,
-                   const object& lexical_environment,
-                   const object& continuation, bool = false)
+    object sequential_let(const object& expression,
+                          const object& lexical_environment,
+                          const object& continuation,
+                          const bool optimization = false)
     {
-      if (expression && expression.is<pair>())
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {"The let* syntax is defined as the form (let* <bindings> <body>) but lacks <body>."};
+      }
+      else if (not car(expression) or not cdar(expression))
+      {
+        return let(expression, lexical_environment, continuation, optimization);
+      }
+      else
       {
         return
-          operand(
-            cdr(expression),
+          block(
+            list(caaar(expression)),
+            list(cadaar(expression)),
             lexical_environment,
-            compile(
-              car(expression),
-              lexical_environment,
-              cons(
-                make<instruction>(mnemonic::PUSH),
-                continuation)));
+            continuation,
+            optimization,
+            [&](const object& extended_environment, const object& continuation, const bool optimization)
+            {
+              return
+                sequential_let(
+                  cons(cdar(expression), cdr(expression)),
+                  extended_environment,
+                  continuation,
+                  optimization);
+            });
+      }
+    }
+
+    /*
+     * <letrec*> = (letrec* (<binding spec>*) <body>)
+     *
+     * letrec is also compiled as letrec*, which is a valid implementation of
+     * letrec.
+     */
+    object recursive_let(const object& expression,
+                         const object& lexical_environment,
+                         const object& continuation,
+                         const bool optimization = false)
+    {
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {"The letrec syntax is defined as the form (letrec <bindings> <body>) but lacks <body>."};
       }
       else
       {
         return
-          compile(
-            expression,
+          recursive_block(
+            car(expression),
+            cdr(expression),
             lexical_environment,
-            continuation);
+            continuation,
+            optimization);
       }
     }
 
-    /**
-     * <conditional> = (if <test> <consequent> <alternate>)
-     **/
-    object conditional(const object& expression,
-                       const object& lexical_environment,
-                       const object& continuation,
-                       const bool optimization = false)
+    /*
+     * <values> = (values <expression>*)
+     *
+     * The operands are evaluated into a list as usual, then VALUES returns
+     * the only one of them, or the list as multiple values.
+     */
+    object multiple_values(const object& expression,
+                           const object& lexical_environment,
+                           const object& continuation,
+                           const bool = false)
     {
-      DEBUG_COMPILE(
-        car(expression) << highlight::comment << "\t; is <test>"
-                        << attribute::normal << std::endl);
+      return
+        operand(
+          expression,
+          lexical_environment,
+          cons(
+            make<instruction>(mnemonic::VALUES),
+            continuation));
+    }
 
-      if (optimization)
+    /*
+     * <call-with-values> = (call-with-values <producer> <consumer>)
+     *
+     * CALL_WITH_VALUES turns the values of the producer into the operands of
+     * the consumer without copying them. A producer of the form (lambda ()
+     * <body>) is compiled as its body, and a consumer of the form (lambda
+     * <formals> <body>) as a block, so neither of them makes a closure.
+     */
+    object call_with_values(const object& expression,
+                            const object& lexical_environment,
+                            const object& continuation,
+                            const bool optimization = false)
+    {
+      if (not expression or not cdr(expression) or cddr(expression))
       {
-        const auto consequent {
-          compile(
-            cadr(expression),
-            lexical_environment,
-            list(
-              make<instruction>(mnemonic::RETURN)),
-            true)
-        };
+        throw syntax_error {"The call-with-values syntax is defined as the form (call-with-values <producer> <consumer>)."};
+      }
 
-        const auto alternate {
-          cddr(expression)
-            ? compile(
-                caddr(expression),
-                lexical_environment,
-                list(
-                  make<instruction>(mnemonic::RETURN)),
-                true)
-            : list(
-                make<instruction>(mnemonic::LOAD_LITERAL),
-                undefined,
-                make<instruction>(mnemonic::RETURN))
-        };
+      const auto lambda = [&](const object& x)
+      {
+        return x and x.is<pair>() and is_special(car(x), lexical_environment, "lambda") and cdr(x) and cddr(x);
+      };
 
+      const auto& producer {car(expression)};
+      const auto& consumer {cadr(expression)};
+
+      const object consumption {
+        lambda(consumer)
+          ? enter(
+              cadr(consumer),
+              lexical_environment,
+              continuation,
+              optimization,
+              [&](const object& extended_environment, const object& continuation, const bool optimization)
+              {
+                return body(cddr(consumer), extended_environment, continuation, optimization);
+              })
+          : compile(
+              consumer,
+              lexical_environment,
+              cons(
+                make<instruction>(optimization ? mnemonic::APPLY_TAIL : mnemonic::APPLY),
+                continuation))
+      };
+
+      if (lambda(producer) and not cadr(producer))
+      {
         return
-          compile(
-            car(expression), // <test>
+          body(
+            cddr(producer),
             lexical_environment,
-            cons(
-              make<instruction>(mnemonic::SELECT_TAIL),
-              consequent,
-              alternate,
-              cdr(continuation)));
+            cons(make<instruction>(mnemonic::CALL_WITH_VALUES), consumption));
       }
       else
       {
-        const auto consequent {
+        return
           compile(
-            cadr(expression),
+            list(producer),
             lexical_environment,
-            list(make<instruction>(mnemonic::JOIN)))
-        };
+            cons(make<instruction>(mnemonic::CALL_WITH_VALUES), consumption));
+      }
+    }
 
-        const auto alternate {
-          cddr(expression)
-            ? compile(
-                caddr(expression),
-                lexical_environment,
-                list(make<instruction>(mnemonic::JOIN)))
-            : list(
-                make<instruction>(mnemonic::LOAD_LITERAL), undefined,
-                make<instruction>(mnemonic::JOIN))
-        };
+    /*
+     * <receive> = (receive <formals> <expression> <body>)
+     *
+     * The values of the expression are the frame of a block.
+     */
+    object receive(const object& expression,
+                   const object& lexical_environment,
+                   const object& continuation,
+                   const bool optimization = false)
+    {
+      if (not expression or not cdr(expression) or not cddr(expression))
+      {
+        throw syntax_error {"The receive syntax is defined as the form (receive <formals> <expression> <body>) but lacks <body>."};
+      }
+
+      return
+        compile(
+          cadr(expression),
+          lexical_environment,
+          cons(
+            make<instruction>(mnemonic::CALL_WITH_VALUES),
+            enter(
+              car(expression),
+              lexical_environment,
+              continuation,
+              optimization,
+              [&](const object& extended_environment, const object& continuation, const bool optimization)
+              {
+                return body(cddr(expression), extended_environment, continuation, optimization);
+              })));
+    }
+
+    /*
+     * <let-values> = (let-values (<mv binding spec>*) <body>)
+     *
+     * <mv binding spec> = (<formals> <expression>)
+     *
+     * All the expressions are evaluated in the outer environment, then each
+     * frame of values is entered as a block, the last one first.
+     */
+    object let_values(const object& expression,
+                      const object& lexical_environment,
+                      const object& continuation,
+                      const bool optimization = false)
+    {
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {"The let-values syntax is defined as the form (let-values <mv binding spec> <body>) but lacks <body>."};
+      }
+      else if (not car(expression))
+      {
+        return let(expression, lexical_environment, continuation, optimization);
+      }
+
+      const std::function<object (const object&, const object&, const object&, bool)> enter_each = [&](
+        const object& bindings, // in reverse order
+        const object& lexical_environment,
+        const object& continuation,
+        const bool optimization) -> object
+      {
+        return
+          enter(
+            caar(bindings),
+            lexical_environment,
+            continuation,
+            optimization,
+            [&](const object& extended_environment, const object& continuation, const bool optimization)
+            {
+              if (cdr(bindings))
+              {
+                return enter_each(cdr(bindings), extended_environment, continuation, optimization);
+              }
+              else
+              {
+                return body(cdr(expression), extended_environment, continuation, optimization);
+              }
+            });
+      };
+
+      object bindings {unit};
+
+      for (auto each {car(expression)}; each; each = cdr(each))
+      {
+        bindings = cons(car(each), bindings);
+      }
 
+      auto code {enter_each(bindings, lexical_environment, continuation, optimization)};
+
+      for (const auto& binding : bindings)
+      {
+        code = compile(
+                 cadr(binding),
+                 lexical_environment,
+                 cons(
+                   make<instruction>(mnemonic::CALL_WITH_VALUES),
+                   code));
+      }
+
+      return code;
+    }
+
+    /*
+     * <let*-values> = (let*-values (<mv binding spec>*) <body>)
+     *
+     * Each mv binding spec is compiled as receive, nested in the previous one.
+     */
+    object sequential_let_values(const object& expression,
+                                 const object& lexical_environment,
+                                 const object& continuation,
+                                 const bool optimization = false)
+    {
+      if (not expression or not cdr(expression))
+      {
+        throw syntax_error {"The let*-values syntax is defined as the form (let*-values <mv binding spec> <body>) but lacks <body>."};
+      }
+      else if (not car(expression) or not cdar(expression))
+      {
+        return let_values(expression, lexical_environment, continuation, optimization);
+      }
+      else
+      {
         return
           compile(
-            car(expression), // <test>
+            cadaar(expression),
             lexical_environment,
             cons(
-              make<instruction>(mnemonic::SELECT),
-              consequent,
-              alternate,
-              continuation));
+              make<instruction>(mnemonic::CALL_WITH_VALUES),
+              enter(
+                caaar(expression),
+                lexical_environment,
+                continuation,
+                optimization,
+                [&](const object& extended_environment, const object& continuation, const bool optimization)
+                {
+                  return
+                    sequential_let_values(
+                      cons(cdar(expression), cdr(expression)),
+                      extended_environment,
+                      continuation,
+                      optimization);
+                })));
       }
     }
 
@@ -1062,16 +3612,12 @@ namespace meevax::kernel
         car(expression) << highlight::comment << "\t; is <formals>"
                         << attribute::normal << std::endl);
 
+      capture();
+
       return
         cons(
           make<instruction>(mnemonic::MAKE_CLOSURE),
-          body(
-            cdr(expression), // <body>
-            cons(
-              car(expression),
-              lexical_environment), // extend lexical environment
-            list(
-              make<instruction>(mnemonic::RETURN))), // continuation of body (finally, must be return)
+          closure_body(expression, lexical_environment),
           continuation);
     }
 
@@ -1084,6 +3630,8 @@ namespace meevax::kernel
         car(expression) << highlight::comment << "\t; is <procedure>"
                         << attribute::normal << std::endl);
 
+      capture();
+
       return
         cons(
           make<instruction>(mnemonic::MAKE_CONTINUATION),
@@ -1125,14 +3673,12 @@ namespace meevax::kernel
         car(expression) << highlight::comment << "\t; is <formals>"
                         << attribute::normal << std::endl);
 
+      capture();
+
       return
         cons(
           make<instruction>(mnemonic::MAKE_ENVIRONMENT),
-          // program(
-          body(
-            cdr(expression),
-            cons(car(expression), lexical_environment),
-            list(make<instruction>(mnemonic::RETURN))),
+          closure_body(expression, lexical_environment),
           continuation);
     }
 
@@ -1148,33 +3694,51 @@ namespace meevax::kernel
       }
       else if (de_bruijn_index index {car(expression), lexical_environment}; index)
       {
-        // XXX デバッグ用のトレースがないなら条件演算子でコンパクトにまとめたほうが良い
-        if (index.is_variadic())
+        if (index.is_constant())
         {
-          DEBUG_COMPILE_DECISION(
-            "<identifier> of lexical variadic " << attribute::normal << index);
-
-          return
-            compile(
-              cadr(expression),
-              lexical_environment,
-              cons(
-                make<instruction>(mnemonic::SET_LOCAL_VARIADIC), index,
-                continuation));
+          throw assignment_to_constant {index.frame()};
         }
         else
         {
-          DEBUG_COMPILE_DECISION("<identifier> of lexical " << attribute::normal << index);
+          auto* const record {scope_of(index, lexical_environment)};
+
+          assert(record); // every lexical frame has its scope
+
+          DEBUG_COMPILE_DECISION("<identifier> of lexical cell " << attribute::normal << index);
+
+          ++record->assignments[int {cdr(index).template as<real>()}];
+
+          if (const auto& value {cadr(expression)}; value and value.is<pair>() and is_special(car(value), lexical_environment, "lambda"))
+          {
+            assignee = car(expression);
+          }
 
           return
             compile(
               cadr(expression),
               lexical_environment,
               cons(
-                make<instruction>(mnemonic::SET_LOCAL), index,
+                make<instruction>(mnemonic::SET_CELL), index,
                 continuation));
         }
       }
+      else if (const object slot {resolve(car(expression))}; slot)
+      {
+        if (car(slot) != defining)
+        {
+          throw syntax_error {"imported variable ", car(expression), " cannot be assigned"};
+        }
+
+        DEBUG_COMPILE_DECISION("<identifier> of slot " << attribute::normal << cdr(slot));
+
+        return
+          compile(
+            cadr(expression),
+            lexical_environment,
+            cons(
+              make<instruction>(mnemonic::STORE_SLOT), slot,
+              continuation));
+      }
       else
       {
         DEBUG_COMPILE_DECISION("<identifier> of dynamic variable" << attribute::normal);
@@ -429,7 +429,7 @@ namespace meevax::kernel
 
         token.push_back(*head);
 
-        if (auto c {stream.peek()}; is_delimiter(c)) // delimiter
+        if (auto c {stream.peek()}; is_delimiter(c) or c == std::char_traits<char>::eof()) // delimiter or end of input
         {
           if (token == ".")
           {
@@ -0,0 +1,48 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_STUB_HPP
+#define INCLUDED_MEEVAX_KERNEL_STUB_HPP
+
+#include <atomic>
+#include <mutex>
+
+#include <meevax/kernel/pair.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Stub is the value of a global variable whose definition is not compiled
+  * yet. The car is the lambda expression of the definition, and the cdr is
+  * the global environment when it was defined, in which the expression is
+  * compiled on the first reference to the variable (see
+  * machine::materialize). Layer 1 is booted from source into stubs, so only
+  * the procedures used by the program are ever compiled.
+  *========================================================================= */
+  struct stub
+    : public virtual pair
+  {
+    template <typename... Ts>
+    explicit stub(Ts&&... operands)
+      : pair {std::forward<decltype(operands)>(operands)...}
+    {}
+
+    static inline std::atomic<std::size_t> deferred {0},
+                                           materialized {0};
+
+    /* ------------------------------------------------------------------------
+    * Workers may reference the same stub at once. The mutex is recursive,
+    * since compiling a definition may run a macro that references another
+    * stub.
+    *----------------------------------------------------------------------- */
+    static inline std::recursive_mutex mutex {};
+  };
+
+  std::ostream& operator<<(std::ostream& os, const stub& stub)
+  {
+    return os << highlight::syntax << "#("
+              << highlight::constructor << "stub"
+              << attribute::normal << highlight::comment << " #;" << &stub << attribute::normal
+              << highlight::syntax << ")"
+              << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_STUB_HPP
@@ -2,15 +2,23 @@
 #define INCLUDED_MEEVAX_KERNEL_SYNTACTIC_CONTINUATION_HPP
 
 #include <algorithm> // std::equal
+#include <cstdio> // std::remove, std::rename
+#include <iomanip> // std::setw
 #include <numeric> // std::accumulate
+#include <shared_mutex>
+#include <unordered_set>
 
 /**
  * Global configuration generated by CMake before compilation.
  */
 #include <meevax/kernel/configurator.hpp>
+#include <meevax/kernel/image.hpp>
 #include <meevax/kernel/machine.hpp>
 #include <meevax/kernel/reader.hpp>
 #include <meevax/kernel/file.hpp>
+#include <meevax/kernel/future.hpp>
+#include <meevax/kernel/thread_pool.hpp>
+#include <meevax/posix/executable.hpp>
 #include <meevax/posix/linker.hpp>
 
 /* ============================================================================
@@ -23,6 +31,16 @@
 extern char _binary_layer_1_ss_start;
 extern char _binary_layer_1_ss_end;
 
+/* ============================================================================
+* Embedded Heap Image
+*
+*   layer-1.image (written by meevax-bootstrap at build time)
+*
+* Weak, because the bootstrap executable itself has no image.
+*=========================================================================== */
+extern char _binary_layer_1_image_start __attribute__((weak));
+extern char _binary_layer_1_image_end __attribute__((weak));
+
 namespace meevax::kernel
 {
   /* ==========================================================================
@@ -58,14 +76,38 @@ namespace meevax::kernel
     , public machine<syntactic_continuation>
 
     /* ========================================================================
-    * Global configuration is shared in all of syntactic_continuations running on same
-    * process. Thus, any change of configuration member influences any other
-    * syntactic_continuations immediately.
+    * Each syntactic_continuation has its own configuration. Macros made by
+    * the virtual machine (see transformer) have none and are expanded under
+    * the configuration of the compiling one, while independent syntactic
+    * continuations (isolates) running on other threads never see each
+    * other's configuration.
     *======================================================================= */
     , public configurator<syntactic_continuation>
+
+    /* ========================================================================
+    * The booted global environment can be written to a heap image, and read
+    * back instead of booting layer 1 from source.
+    *======================================================================= */
+    , public image<syntactic_continuation>
   {
+    friend class image<syntactic_continuation>;
+
     std::unordered_map<std::string, object> symbols;
 
+    /* ------------------------------------------------------------------------
+    * The compiler recognizes keywords by the identity of interned symbols, so
+    * workers (see employ) intern into the symbol table of the syntactic
+    * continuation which made them, instead of into one of their own. It may
+    * be interned by some threads at once.
+    *----------------------------------------------------------------------- */
+    syntactic_continuation* parent {nullptr};
+
+    std::shared_mutex symbols_mutex;
+
+    std::once_flag pool_initialization;
+
+    std::unique_ptr<thread_pool> pool_;
+
     // std::unordered_map<object, object> bindings;
     //
     // static inline std::unordered_map<std::string, posix::linker> linkers {};
@@ -88,17 +130,25 @@ namespace meevax::kernel
       return reader<syntactic_continuation>::ready();
     }
 
-    const auto& intern(const std::string& s)
+    const object& intern(const std::string& s)
     {
-      if (auto iter {symbols.find(s)}; iter != std::end(symbols))
+      if (parent)
       {
-        return iter->second;
+        return parent->intern(s);
       }
-      else
+
       {
-        iter = symbols.emplace(s, make<symbol>(s)).first;
-        return iter->second;
+        const std::shared_lock<std::shared_mutex> lock {symbols_mutex};
+
+        if (auto iter {symbols.find(s)}; iter != std::end(symbols))
+        {
+          return iter->second;
+        }
       }
+
+      const std::unique_lock<std::shared_mutex> lock {symbols_mutex};
+
+      return symbols.emplace(s, make<symbol>(s)).first->second; // unless interned meanwhile
     }
 
     template <typename T, typename... Ts>
@@ -193,29 +243,6 @@ namespace meevax::kernel
       return static_cast<stack&>(std::get<1>(*this));
     }
 
-    decltype(auto) expand(const object& operands)
-    {
-      // std::cerr << "; macroexpand\t; " << operands << std::endl;
-
-      // std::cerr << "DEBUG! operands = " << operands << std::endl;
-      // std::cerr << "DEBUG! lexical = " << lexical_environment() << std::endl;
-      // std::cerr << "DEBUG! " << cons(operands, lexical_environment()) << std::endl;
-      ++time_stamp;
-
-      s = unit;
-      e = cons(operands, lexical_environment());
-      c = current_expression();
-      d = cons(
-            unit,                                    // s
-            unit,                                    // e
-            list(make<instruction>(mnemonic::STOP)), // c
-            unit);                                   // d
-
-      const auto result {execute()};
-      // std::cerr << "; \t\t; " << result << std::endl;
-      return result;
-    }
-
     template <typename... Ts>
     decltype(auto) evaluate(Ts&&... operands)
     {
@@ -235,292 +262,1309 @@ namespace meevax::kernel
     //   }
     // }
 
-    auto locate_library(const object& name)
+    /* ==== Compiled-File Cache ===============================================
+    *
+    * The code compiled from the toplevel forms of a file is written to a
+    * cache by "compile-file", and by "load" if "--compile-cache" (or
+    * "--cache-directory") is given. The cache is "<path>.compiled", or
+    * "<directory>/<hash>.compiled" if the directory is given. Then the next
+    * load of the same source evaluates the cached code instead of reading and
+    * compiling it.
+    *
+    * The cache is keyed by the hash of the source, the build (see image.hpp)
+    * and "--optimize", and is recompiled if any of them does not match. Each
+    * form is compiled in the global environment made by the preceding ones,
+    * so the cache also assumes that the file is loaded on the same global
+    * environment (e.g. macros used by the file are not redefined). This is
+    * why the cache is not used unless asked for.
+    *
+    *======================================================================= */
+    auto cache_key(const std::string& source) const
     {
-      for (const object& each : interaction_environment())
+      std::uint64_t hash {0xCBF29CE484222325}; // FNV-1a
+
+      for (const auto each : source)
       {
-        if (const object& key {car(each)}; not key.is<symbol>())
-        {
-          if (is_same(key, name))
-          {
-            return cadr(each);
-          }
-        }
+        hash = (hash ^ static_cast<unsigned char>(each)) * 0x100000001B3;
       }
 
-      return unit;
-    }
-
-    [[deprecated]] auto import_library(const object& library, const object& continuation)
-    {
-      stack executable {continuation};
+      std::stringstream key {};
 
-      assert(library.is<syntactic_continuation>());
+      key << std::hex << std::setw(16) << std::setfill('0') << hash;
 
-      for (const object& each : library.as<syntactic_continuation>().interaction_environment())
+      if (optimize == true_object)
       {
-        executable.push(
-          make<instruction>(mnemonic::LOAD_LITERAL), cadr(each),
-          make<instruction>(mnemonic::DEFINE), rename(car(each)));
+        key << "-optimize";
       }
 
-      return executable;
+      return key.str();
     }
 
-    // auto import_(const object& library, const object& continuation)
-    // {
-    //   auto& source {library.as<syntactic_continuation>()};
-    //
-    //   if (source.bindings.empty())
-    //   {
-    //     source.expand(list(library));
-    //
-    //     if (source.bindings.empty())
-    //     {
-    //       throw syntax_error {library, " is may not be library"};
-    //     }
-    //   }
-    //
-    //   stack executable {continuation};
-    //
-    //   for (const auto& [key, value] : source.bindings)
-    //   {
-    //     executable.push(_load_literal_, value, make<instruction>(mnemonic::DEFINE), rename(key));
-    //   }
-    //
-    //   return executable;
-    // }
-
-    template <typename... Ts>
-    decltype(auto) load(Ts&&... operands)
+    auto cache_path(const std::string& path, const std::string& key) const
     {
-      const std::string path {std::forward<decltype(operands)>(operands)...};
+      if (cache_directory)
+      {
+        return (cache_directory.as<kernel::path>() / (key + ".compiled")).string();
+      }
+      else
+      {
+        return path + ".compiled";
+      }
+    }
 
+    /* ------------------------------------------------------------------------
+    * Evaluate the file, and return the path of its cache. If "recompile", the
+    * cache is written. Otherwise it is used and written only if enabled, and
+    * failure to write it is ignored.
+    *----------------------------------------------------------------------- */
+    auto load_file(const std::string& path, bool recompile)
+    {
       if (verbose == true_object or verbose_loader == true_object)
       {
         std::cerr << "; loader\t; open \"" << path << "\" => ";
       }
 
-      if (std::fstream stream {path}; stream)
+      std::ifstream stream {path};
+
+      if (not stream)
+      {
+        if (verbose == true_object or verbose_loader == true_object)
+        {
+          std::cerr << "failed" << std::endl;
+        }
+
+        throw evaluation_error {"failed to open file ", std::quoted(path)};
+      }
+      else if (verbose == true_object or verbose_loader == true_object)
+      {
+        std::cerr << "succeeded" << std::endl;
+      }
+
+      const std::string source {std::istreambuf_iterator<char> {stream}, {}};
+
+      const auto key {cache_key(source)};
+
+      const auto cache {cache_path(path, key)};
+
+      const bool caching {recompile or compile_cache == true_object or cache_directory};
+
+      std::vector<object> codes {};
+
+      bool cached {false};
+
+      if (std::ifstream port {cache, std::ios::binary}; port and caching and not recompile) try
+      {
+        codes = restore_code(port, key);
+        cached = true;
+      }
+      catch (const exception& error) // stale or broken, so recompile
+      {
+        if (verbose == true_object or verbose_loader == true_object)
+        {
+          std::cerr << "; loader\t; " << error << std::endl;
+        }
+      }
+      catch (const std::exception& error)
+      {
+        if (verbose == true_object or verbose_loader == true_object)
+        {
+          std::cerr << "; loader\t; " << error.what() << std::endl;
+        }
+      }
+
+      d.push(s, e, c);
+      s = e = c = unit;
+
+      if (cached)
       {
         if (verbose == true_object or verbose_loader == true_object)
         {
-          std::cerr << "succeeded" << std::endl;
+          std::cerr << "; loader\t; evaluate " << std::size(codes) << " forms cached in \"" << cache << "\"" << std::endl;
         }
 
-        d.push(s, e, c);
-        s = e = c = unit;
+        for (const auto& code : codes)
+        {
+          execute(code);
+        }
+      }
+      else
+      {
+        std::stringstream port {source};
 
-        for (auto e {read(stream)}; e != characters.at("end-of-file"); e = read(stream))
+        for (auto e {read(port)}; e != characters.at("end-of-file"); e = read(port))
         {
           if (verbose == true_object or verbose_reader == true_object)
           {
             std::cerr << "; read\t\t; " << e << std::endl;
           }
 
-          evaluate(e);
+          codes.push_back(compile(e));
+          execute(codes.back());
         }
+      }
 
-        s = d.pop();
-        e = d.pop();
-        c = d.pop();
+      s = d.pop();
+      e = d.pop();
+      c = d.pop();
 
-        return unspecified;
-      }
-      else
+      if (caching and not cached)
       {
-        if (verbose == true_object or verbose_loader == true_object)
+        const auto temporary {cache + ".tmp"};
+
+        try
         {
-          std::cerr << "failed" << std::endl;
+          if (std::ofstream port {temporary, std::ios::binary}; port)
+          {
+            dump_code(port, key, codes);
+          }
+          else
+          {
+            throw kernel_error {"failed to open file ", std::quoted(temporary)};
+          }
+
+          if (std::rename(temporary.c_str(), cache.c_str()))
+          {
+            throw kernel_error {"failed to rename file ", std::quoted(temporary)};
+          }
         }
+        catch (const exception& error)
+        {
+          std::remove(temporary.c_str());
 
-        throw evaluation_error {"failed to open file ", std::quoted(path)};
+          if (recompile)
+          {
+            throw;
+          }
+          else if (verbose == true_object or verbose_loader == true_object)
+          {
+            std::cerr << "; loader\t; " << error << std::endl;
+          }
+        }
       }
+
+      return cache;
     }
-  };
 
-  template <>
-  syntactic_continuation::syntactic_continuation(std::integral_constant<int, 0>)
-  {
-    define<special>("quote", [&](auto&&... operands)
+    template <typename... Ts>
+    decltype(auto) load(Ts&&... operands)
     {
-      return quotation(std::forward<decltype(operands)>(operands)...);
-    });
+      load_file(std::string {std::forward<decltype(operands)>(operands)...}, false);
+      return unspecified;
+    }
 
-    define<special>("if", [&](auto&&... operands)
+    /* ------------------------------------------------------------------------
+    * Write the cache of the file ahead of time. The file is also evaluated,
+    * since the compilation of each form depends on the preceding ones.
+    *----------------------------------------------------------------------- */
+    template <typename... Ts>
+    decltype(auto) compile_file(Ts&&... operands)
     {
-      return conditional(std::forward<decltype(operands)>(operands)...);
-    });
+      return load_file(std::string {std::forward<decltype(operands)>(operands)...}, true);
+    }
 
-    define<special>("define", [&](auto&&... operands)
+    /* ------------------------------------------------------------------------
+    * Whether the toplevel form defines a macro, that is, "define-syntax" or a
+    * definition whose value is made by "call-with-current-syntactic-
+    * continuation" (call/csc) or "environment". Such definitions are also
+    * evaluated where the program is only compiled (see build_executable and
+    * define_library), since the following forms need the macros to be
+    * compiled.
+    *----------------------------------------------------------------------- */
+    bool syntax_definition(const object& form)
     {
-      return definition(std::forward<decltype(operands)>(operands)...);
-    });
+      if (not form or not form.is<pair>() or not cdr(form) or not cddr(form))
+      {
+        return false;
+      }
+      else if (car(form) == intern("define-syntax"))
+      {
+        return true;
+      }
+      else if (is_special(car(form), unit, "define"))
+      {
+        const object& value {caddr(form)};
 
-    define<special>("begin", [&](auto&&... operands)
-    {
-      return sequence(std::forward<decltype(operands)>(operands)...);
-    });
+        return value and value.is<pair>()
+                     and (is_special(car(value), unit, "call-with-current-syntactic-continuation") or
+                          is_special(car(value), unit, "environment"));
+      }
+      else
+      {
+        return false;
+      }
+    }
 
-    define<special>("call-with-current-continuation", [&](auto&&... operands)
+    /* ------------------------------------------------------------------------
+    * Compile the script given on the command line, and write a standalone
+    * executable which runs it with the tree-shaken global environment (see
+    * image::dump_program and posix::embed).
+    *
+    * The program is compiled, but not evaluated, except the definitions of
+    * macros (see syntax_definition).
+    *----------------------------------------------------------------------- */
+    void build_executable(const std::string& output)
     {
-      return call_cc(std::forward<decltype(operands)>(operands)...);
-    });
+      if (not script_file)
+      {
+        throw configuration_error {"build-executable requires the script"};
+      }
 
-    define<special>("lambda", [&](auto&&... operands)
-    {
-      return lambda(std::forward<decltype(operands)>(operands)...);
-    });
+      std::ifstream stream {script_file.as<path>().string()};
 
-    define<special>("environment", [&](auto&&... operands)
-    {
-      return abstraction(std::forward<decltype(operands)>(operands)...);
-    });
+      if (not stream)
+      {
+        throw evaluation_error {"failed to open file ", script_file};
+      }
 
-    define<special>("call-with-current-syntactic-continuation", [&](auto&&... operands)
-    {
-      return call_csc(std::forward<decltype(operands)>(operands)...);
-    });
+      std::stringstream port {std::string {std::istreambuf_iterator<char> {stream}, {}}};
 
-    define<special>("set!", [&](auto&&... operands)
-    {
-      return assignment(std::forward<decltype(operands)>(operands)...);
-    });
+      std::vector<object> codes {};
 
-    /*
-     * <importation> = (import <library name>)
-     */
-    // define<special>("import", [&](auto&& expression,
-    //                              auto&& lexical_environment,
-    //                              auto&& continuation, auto)
-    // {
-    //   using meevax::kernel::path;
-    //
-    //   if (const object& library_name {car(expression)}; not library_name)
-    //   {
-    //     throw syntax_error {"empty library-name is not allowed"};
-    //   }
-    //   else if (const object& library {locate_library(library_name)}; library)
-    //   {
-    //     DEBUG_COMPILE_SYNTAX(library_name << " => found library " << library_name << " in this environment as " << library << std::endl);
-    //
-    //     /*
-    //      * Passing the VM instruction to load literally library-name as
-    //      * continuation is for return value of this syntax form "import".
-    //      */
-    //     // return import_library(library, cons(_load_literal_, library_name, continuation));
-    //     return import_(library, cons(_load_literal_, library_name, continuation));
-    //   }
-    //   else // XXX Don't use this library style (deprecated)
-    //   {
-    //     DEBUG_COMPILE_SYNTAX("(\t; => unknown library-name" << std::endl);
-    //     NEST_IN;
-    //
-    //     /**********************************************************************
-    //     * Macro expander for to evaluate library-name on operand compilation
-    //     * rule.
-    //     **********************************************************************/
-    //     syntactic_continuation macro {
-    //       unit,
-    //       interaction_environment()
-    //     }; // TODO IN CONSTRUCTOR INITIALIZATION
-    //
-    //     path library_path {""};
-    //
-    //     for (const object& identifier : macro.execute(operand(library_name, lexical_environment, continuation)))
-    //     {
-    //       if (identifier.is<path>())
-    //       {
-    //         library_path /= identifier.as<path>();
-    //       }
-    //       else if (identifier.is<string>())
-    //       {
-    //         library_path /= path {identifier.as<string>()};
-    //       }
-    //       else
-    //       {
-    //         throw syntax_error {
-    //           identifier, " is not allowed as part of library-name (must be path or string object)"
-    //         };
-    //       }
-    //     }
-    //
-    //     NEST_OUT_SYNTAX;
-    //
-    //     std::cerr << "; import\t; dynamic-link " << library_path << std::endl;
-    //
-    //     // TODO ADD FUNCTION CALL OPERATOR TO LINKER
-    //     // const object& linker {make<posix::linker>(library_path.c_str())};
-    //
-    //     // machine<syntactic_continuation>::define(
-    //     //   library_name,
-    //     //   std::invoke(
-    //     //     dynamic_link(library_path).link<procedure::signature>("library"),
-    //     //     unit
-    //     //   )
-    //     // );
-    //
-    //     const object exported {std::invoke(
-    //       dynamic_link(library_path).link<procedure::signature>("library"),
-    //       // linker.as<posix::linker>().link<procedure::signature>("library"),
-    //       unit // TODO PASS SOMETHING USEFUL TO LIBRARY INITIALIZER
-    //     )};
-    //
-    //     /*
-    //      * Passing the VM instruction to load literally library-name as
-    //      * continuation is for return value of this syntax form "import".
-    //      */
-    //     auto decralations {import_library(
-    //        exported, cons(_load_literal_, library_name, continuation)
-    //      )};
-    //     // return import_library(
-    //     //    locate_library(library_name),
-    //     //    cons(_load_literal_, library_name, continuation)
-    //     //  );
-    //
-    //     /**********************************************************************
-    //     * Push VM instruction for define the library exported from
-    //     * shared-object as given library-name (this will execute on first of VM
-    //     * instruction which result of this function).
-    //     **********************************************************************/
-    //     return decralations.push(_load_literal_, exported, make<instruction>(mnemonic::DEFINE), library_name);
-    //   }
-    // });
+      for (auto e {read(port)}; e != characters.at("end-of-file"); e = read(port))
+      {
+        codes.push_back(compile(e));
 
-    define<procedure>("load", [&](const object& operands)
+        if (syntax_definition(e))
+        {
+          execute(codes.back());
+        }
+      }
+
+      std::ostringstream image {};
+
+      dump_program(image, codes);
+
+      posix::embed(output, image.str());
+    }
+
+    /* ==== Libraries =========================================================
+    *
+    * A library defined by "define-library" is registered by its name (see
+    * library::key). A library imported but not registered yet is loaded from
+    * the file "<key>.sld" (e.g. "example/grid.sld" for (example grid)) under
+    * the directory given by "--library-directory". It is loaded as by "load",
+    * so with "--compile-cache" each library file is compiled once, and its
+    * later loads evaluate the cached code.
+    *
+    * The standard libraries (scheme ...) and (srfi ...) are the global
+    * environment booted from layer 1, whose bindings are visible from
+    * anywhere unless shadowed, so importing them imports nothing.
+    *
+    *======================================================================= */
+    std::unordered_map<std::string, object> libraries;
+
+    std::unordered_set<std::string> loading; // keys of the libraries being loaded
+
+    auto library_path(const std::string& key) const
     {
-      return load(car(operands).as<const string>());
-    });
+      if (library_directory)
+      {
+        return (library_directory.as<kernel::path>() / (key + ".sld")).string();
+      }
+      else
+      {
+        return key + ".sld";
+      }
+    }
 
-    define<procedure>("linker", [&](auto&& operands)
+    object find_library(const object& name)
     {
-      if (auto size {length(operands)}; size < 1)
+      const auto key {library::key(name)};
+
+      if (auto iter {libraries.find(key)}; iter != std::end(libraries))
       {
-        throw evaluation_error {
-          "procedure linker expects a string for argument, but received nothing."
-        };
+        return iter->second;
       }
-      else if (const object& s {car(operands)}; not s.is<string>())
+      else if (car(name) == intern("scheme") or car(name) == intern("srfi"))
       {
-        throw evaluation_error {
-          "procedure linker expects a string for argument, but received ",
-          meevax::utility::demangle(s.type()),
-          " rest ", size, " argument",
-          (size < 2 ? " " : "s "),
-          "were ignored."
-        };
+        return unit;
+      }
+      else if (loading.count(key))
+      {
+        throw syntax_error {"library ", name, " is imported while it is loaded"};
+      }
+
+      /* ----------------------------------------------------------------------
+      * The file is loaded at toplevel, even if imported while the body of
+      * another library is compiled.
+      *--------------------------------------------------------------------- */
+      const auto scope {std::make_tuple(std::exchange(defining, unit), std::exchange(imports, {}))};
+
+      const auto restore = [&]()
+      {
+        std::tie(defining, imports) = scope;
+        loading.erase(key);
+      };
+
+      loading.insert(key);
+
+      try
+      {
+        load_file(library_path(key), false);
+      }
+      catch (...)
+      {
+        restore();
+        throw;
+      }
+
+      restore();
+
+      if (auto iter {libraries.find(key)}; iter != std::end(libraries))
+      {
+        return iter->second;
       }
       else
       {
-        return make<meevax::posix::linker>(s.as<string>());
+        throw syntax_error {"file ", std::quoted(library_path(key)), " does not define library ", name};
       }
-    });
+    }
 
-    define<procedure>("native", [&](const homoiconic_iterator& operands)
+    /* ------------------------------------------------------------------------
+    * Resolve a library recorded in a heap image or a cache (see image.hpp).
+    * Unless registered, it is made from the record if the record has its
+    * slots (of a program image), or if there is no file of the library or
+    * the file is the one being loaded (then the code being restored defines
+    * it). Otherwise it is loaded from the file.
+    *----------------------------------------------------------------------- */
+    object restore_library(const object& name, const std::vector<object>& names,
+                                               const std::vector<std::pair<object, std::size_t>>& exports,
+                                               const std::vector<object>& slots)
     {
-      // if (auto size {length(operands)}; size < 1)
-      // {
-      //   throw evaluation_error {
+      const auto key {library::key(name)};
+
+      if (not libraries.count(key) and std::empty(slots) and not loading.count(key) and std::ifstream {library_path(key)})
+      {
+        find_library(name);
+      }
+
+      if (auto iter {libraries.find(key)}; iter != std::end(libraries))
+      {
+        if (const auto& slots {iter->second.as<library>().names}; not std::equal(std::begin(names), std::end(names),
+                                                                                  std::begin(slots), std::end(slots)))
+        {
+          throw kernel_error {"heap image requires another version of library ", name};
+        }
+
+        return iter->second;
+      }
+      else
+      {
+        const object result {make<library>(name, unit)};
+
+        for (const auto& each : names)
+        {
+          result.as<library>().slot(each);
+        }
+
+        for (const auto& [external, index] : exports)
+        {
+          result.as<library>().export_(names.at(index), external);
+        }
+
+        if (std::size(slots) == std::size(names))
+        {
+          result.as<library>().slots = slots;
+        }
+
+        libraries.emplace(key, result);
+
+        return result;
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * <import set> = <library name>
+    *              | (only <import set> <identifier> ...)
+    *              | (except <import set> <identifier> ...)
+    *              | (prefix <import set> <identifier>)
+    *              | (rename <import set> (<identifier> <identifier>) ...)
+    *
+    * Return the bindings of the import set, each of which is the pair of the
+    * imported name and the operand of LOAD_SLOT. The import sets of the
+    * standard libraries have no bindings, whatever they are modified by.
+    *----------------------------------------------------------------------- */
+    auto import_set(const object& set) -> std::vector<std::pair<object, object>>
+    {
+      if (not set or not set.is<pair>())
+      {
+        throw syntax_error {"invalid import set ", set};
+      }
+      else if (cdr(set) and cadr(set) and cadr(set).is<pair>()) // modified
+      {
+        auto bindings {import_set(cadr(set))};
+
+        if (std::empty(bindings))
+        {
+          return bindings;
+        }
+
+        auto find = [&](const object& name)
+        {
+          if (auto iter {std::find_if(std::begin(bindings), std::end(bindings), [&](const auto& each)
+                {
+                  return each.first == name;
+                })}; iter != std::end(bindings))
+          {
+            return iter;
+          }
+          else
+          {
+            throw syntax_error {name, " is not in the import set ", cadr(set)};
+          }
+        };
+
+        if (car(set) == intern("only"))
+        {
+          std::vector<std::pair<object, object>> result {};
+
+          for (const object& each : cddr(set))
+          {
+            result.push_back(*find(each));
+          }
+
+          return result;
+        }
+        else if (car(set) == intern("except"))
+        {
+          for (const object& each : cddr(set))
+          {
+            bindings.erase(find(each));
+          }
+        }
+        else if (car(set) == intern("prefix") and cddr(set) and caddr(set).is<symbol>())
+        {
+          for (auto& each : bindings)
+          {
+            each.first = intern(caddr(set).as<const std::string>() + each.first.as<const std::string>());
+          }
+        }
+        else if (car(set) == intern("rename"))
+        {
+          for (const object& each : cddr(set))
+          {
+            find(car(each))->first = cadr(each);
+          }
+        }
+        else
+        {
+          throw syntax_error {"invalid import set ", set};
+        }
+
+        return bindings;
+      }
+      else if (const object found {find_library(set)}; found)
+      {
+        std::vector<std::pair<object, object>> bindings {};
+
+        for (const auto& each : found.as<library>().exported)
+        {
+          bindings.emplace_back(each, cons(found, make<real>(found.as<library>().exports.at(each.get()))));
+        }
+
+        return bindings;
+      }
+      else
+      {
+        return {};
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * <import declaration> = (import <import set> ...)
+    *
+    * The imported names are bound to the slots in the scope of the compiler
+    * (of the toplevel, or of the library being defined). Nothing is copied
+    * at run time.
+    *----------------------------------------------------------------------- */
+    object import(const object& expression,
+                  const object& lexical_environment,
+                  const object& continuation, const bool = false)
+    {
+      if (lexical_environment)
+      {
+        throw syntax_error {"import cannot appear in this context"};
+      }
+
+      auto& imported {defining ? defining.as<library>().imports : imports};
+
+      for (const object& each : expression)
+      {
+        for (const auto& [name, slot] : import_set(each))
+        {
+          imported.insert_or_assign(name.get(), slot);
+        }
+      }
+
+      return cons(make<instruction>(mnemonic::LOAD_LITERAL), unspecified, continuation);
+    }
+
+    /* ------------------------------------------------------------------------
+    * <library> = (define-library <library name> <library declaration> ...)
+    *
+    * <library declaration> = (export <export spec> ...)
+    *                       | (import <import set> ...)
+    *                       | (begin <command or definition> ...)
+    *
+    * The forms of the "begin" declarations are compiled into one sequence
+    * which stores each definition into its slot. The slots are made before
+    * the sequence is compiled, so each form refers to the definitions of the
+    * others wherever they are. The definitions of macros are also evaluated
+    * at compile time (see syntax_definition).
+    *----------------------------------------------------------------------- */
+    object define_library(const object& expression,
+                          const object& lexical_environment,
+                          const object& continuation, const bool = false)
+    {
+      if (lexical_environment or defining)
+      {
+        throw syntax_error {"define-library cannot appear in this context"};
+      }
+
+      const auto key {library::key(car(expression))};
+
+      const object result {make<library>(car(expression), unit)};
+
+      auto& definitions {result.as<library>()};
+
+      std::function<void (const object&)> declare = [&](const object& body)
+      {
+        for (const object& each : body)
+        {
+          if (not each or not each.is<pair>() or not cdr(each))
+          {
+            continue;
+          }
+          else if (is_special(car(each), unit, "define") and cadr(each) and cadr(each).is<symbol>())
+          {
+            definitions.slot(cadr(each));
+          }
+          else if (is_special(car(each), unit, "begin"))
+          {
+            declare(cdr(each));
+          }
+        }
+      };
+
+      defining = result;
+
+      try
+      {
+        object body {unit};
+
+        for (const object& declaration : cdr(expression))
+        {
+          if (not declaration or not declaration.is<pair>())
+          {
+            throw syntax_error {"invalid library declaration ", declaration};
+          }
+          else if (car(declaration) == intern("export"))
+          {
+            for (const object& each : cdr(declaration))
+            {
+              if (each and each.is<symbol>())
+              {
+                definitions.export_(each, each);
+              }
+              else if (each and each.is<pair>() and car(each) == intern("rename") and cdr(each) and cddr(each))
+              {
+                definitions.export_(cadr(each), caddr(each));
+              }
+              else
+              {
+                throw syntax_error {"invalid export spec ", each};
+              }
+            }
+          }
+          else if (car(declaration) == intern("import"))
+          {
+            import(cdr(declaration), unit, unit);
+          }
+          else if (car(declaration) == intern("begin"))
+          {
+            body = append(body, cdr(declaration));
+          }
+          else
+          {
+            throw syntax_error {"unsupported library declaration ", declaration};
+          }
+        }
+
+        declare(body);
+
+        for (const object& each : body)
+        {
+          if (syntax_definition(each))
+          {
+            d.push(s, e, c);
+            s = e = c = unit;
+
+            execute(compile(each));
+
+            s = d.pop();
+            e = d.pop();
+            c = d.pop();
+          }
+        }
+
+        const auto code {
+          body ? sequence(
+                   body,
+                   unit,
+                   cons(
+                     make<instruction>(mnemonic::POP),
+                     make<instruction>(mnemonic::LOAD_LITERAL), result,
+                     continuation))
+               : cons(
+                   make<instruction>(mnemonic::LOAD_LITERAL), result,
+                   continuation)
+        };
+
+        defining = unit;
+
+        libraries.insert_or_assign(key, result);
+
+        return code;
+      }
+      catch (...)
+      {
+        defining = unit;
+        throw;
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * Boot layer 1 on layer 0. The global environment is restored from the
+    * heap image given by "--image", or from the embedded one if any, and
+    * returns true. Otherwise (or if the image is unusable, e.g. written by
+    * another format version) the embedded source is evaluated under the
+    * default configuration, so that command line options apply only to the
+    * code of the user. Definitions of procedures are bound to stubs, and
+    * compiled when first referenced (see stub.hpp).
+    *----------------------------------------------------------------------- */
+    bool boot()
+    {
+      if (image_file) try
+      {
+        restore_image(image_file.as<path>().string());
+        return true;
+      }
+      catch (const exception& error)
+      {
+        std::cerr << "; image\t\t; " << error << " (ignored)" << std::endl;
+      }
+      catch (const std::exception& error)
+      {
+        std::cerr << "; image\t\t; " << error.what() << " (ignored)" << std::endl;
+      }
+
+      if (&_binary_layer_1_image_start) try
+      {
+        std::istringstream stream {
+          std::string {&_binary_layer_1_image_start, &_binary_layer_1_image_end}
+        };
+
+        restore_image(stream);
+        return true;
+      }
+      catch (const exception& error)
+      {
+        std::cerr << "; layer 1\t; " << error << " (booting from source)" << std::endl;
+      }
+      catch (const std::exception& error)
+      {
+        std::cerr << "; layer 1\t; " << error.what() << " (booting from source)" << std::endl;
+      }
+
+      configurator<syntactic_continuation> configuration {};
+
+      configuration.configure(*this);
+
+      configure(configurator<syntactic_continuation> {});
+
+      static const std::string layer_1 {
+        &_binary_layer_1_ss_start, &_binary_layer_1_ss_end
+      };
+
+      std::stringstream stream {layer_1};
+
+      std::size_t loaded {0};
+
+      for (auto e {read(stream)}; e != characters.at("end-of-file"); e = read(stream))
+      {
+        std::cerr << "; layer 1\t; " << loaded << " expression loaded";
+
+        if (deferrable(e)) // compiled on first reference
+        {
+          defer(e);
+        }
+        else
+        {
+          evaluate(e);
+        }
+
+        ++loaded;
+        std::cerr << "\r" << std::flush;
+      }
+
+      std::cerr << std::endl;
+
+      configure(configuration);
+
+      return false;
+    }
+
+    /* ------------------------------------------------------------------------
+    * Compile every stub and link every native procedure of the global
+    * environment ahead of time, which are otherwise done by their first
+    * reference. The fork server does this once before forking, instead of
+    * every child process doing it again.
+    *----------------------------------------------------------------------- */
+    void warm_up()
+    {
+      for (const object& each : interaction_environment())
+      {
+        auto& binding {cadr(each).as<cell>()};
+
+        if (const object value {binding.load()}; not value)
+        {
+          continue;
+        }
+        else if (value.is<stub>())
+        {
+          materialize(binding, value);
+        }
+        else if (value.is<procedure>())
+        {
+          if (const auto* symbol {value.as<procedure>().target<posix::symbol>()}; symbol)
+          {
+            symbol->link();
+          }
+        }
+      }
+    }
+
+    /* ==== Data Parallelism ==================================================
+    *
+    * The thread pool is constructed on first use, so that syntactic
+    * continuations which never use parallel primitives never spawn threads.
+    * The number of workers is given by command line option "--workers"
+    * (defaults to the number of hardware threads).
+    *
+    *======================================================================= */
+    auto& pool()
+    {
+      std::call_once(pool_initialization, [this]()
+      {
+        pool_ = std::make_unique<thread_pool>(
+                  workers and workers.is<real>() ? int {workers.as<real>()}
+                                     : std::thread::hardware_concurrency());
+      });
+
+      return *pool_;
+    }
+
+    /* ------------------------------------------------------------------------
+    * The global environment to be shared with workers. This may be called by
+    * workers (nested parallelism) while this syntactic continuation defines
+    * new variables, so the head of the environment is loaded atomically.
+    *----------------------------------------------------------------------- */
+    object shared_environment()
+    {
+      return std::atomic_load(&std::get<1>(*this));
+    }
+
+    /* ------------------------------------------------------------------------
+    * The worker which is applying a procedure (see apply) on this thread, if
+    * any. Workers share the primitives of the syntactic continuation which
+    * made them, and the primitives driving its virtual machine (e.g. load,
+    * evaluate) must not be called by them (see reenter).
+    *----------------------------------------------------------------------- */
+    static inline thread_local const syntactic_continuation* applying {nullptr};
+
+    void reenter(const std::string& name) const
+    {
+      if (applying and applying != this)
+      {
+        throw evaluation_error {"procedure ", name, " cannot be called by workers of parallel primitives and futures"};
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * Make the fresh syntactic continuation a worker of this one, which has the
+    * same configuration and symbol table. A worker may compile a stub first
+    * referenced by it (see materialize), which must mean the same as if this
+    * syntactic continuation compiled it.
+    *----------------------------------------------------------------------- */
+    void employ(syntactic_continuation& worker)
+    {
+      worker.configure(*this);
+      worker.parent = this;
+    }
+
+    /* ------------------------------------------------------------------------
+    * Apply procedure to operands on the virtual machine of this syntactic
+    * continuation (a worker), and return the result.
+    *----------------------------------------------------------------------- */
+    object apply(const object& procedure, const object& operands)
+    {
+      const auto previous {std::exchange(applying, this)};
+
+      s = e = d = unit;
+
+      try
+      {
+        const auto result {
+          execute(
+            list(
+              make<instruction>(mnemonic::LOAD_LITERAL), operands,
+              make<instruction>(mnemonic::LOAD_LITERAL), procedure,
+              make<instruction>(mnemonic::APPLY),
+              make<instruction>(mnemonic::STOP)))
+        };
+
+        applying = previous;
+
+        return result;
+      }
+      catch (...)
+      {
+        applying = previous;
+        throw;
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * Invoke function with each index in [0, size) on the thread pool. Indices
+    * are split into contiguous chunks, and each chunk is evaluated on a fresh
+    * syntactic continuation (i.e. its own virtual machine) which shares the
+    * global environment of this syntactic continuation read-only. The calling
+    * thread runs pending tasks while waiting. If some chunks throw, the
+    * exception of the first one (in index order) is rethrown to the caller.
+    *
+    * Procedures that drive the virtual machine of this syntactic continuation
+    * itself (e.g. load, evaluate) throw evaluation_error if called by workers.
+    *----------------------------------------------------------------------- */
+    template <typename Function>
+    void parallel_for(const std::size_t size, Function&& function)
+    {
+      if (size == 0)
+      {
+        return;
+      }
+
+      auto& pool {this->pool()};
+
+      const std::size_t chunks {std::min(size, pool.size() * 4)};
+
+      const object environment {shared_environment()};
+
+      std::atomic<std::size_t> remaining {chunks};
+
+      std::vector<std::exception_ptr> errors (chunks);
+
+      for (std::size_t chunk {0}; chunk < chunks; ++chunk)
+      {
+        pool.submit([&, chunk]()
+        {
+          try
+          {
+            syntactic_continuation worker {unit, environment};
+
+            employ(worker);
+
+            for (auto index {size * chunk / chunks}; index < size * (chunk + 1) / chunks; ++index)
+            {
+              function(worker, index);
+            }
+          }
+          catch (...)
+          {
+            errors[chunk] = std::current_exception();
+          }
+
+          --remaining;
+        });
+      }
+
+      pool.wait_until([&]()
+      {
+        return remaining == 0;
+      });
+
+      for (const auto& each : errors)
+      {
+        if (each)
+        {
+          std::rethrow_exception(each);
+        }
+      }
+    }
+
+    /* ------------------------------------------------------------------------
+    * (parallel-map procedure list1 list2 ...)
+    *
+    * Same as "map", but applications of procedure are distributed to the
+    * thread pool. Results are reassembled in order of the arguments.
+    *----------------------------------------------------------------------- */
+    auto parallel_map(const object& procedure, const object& lists)
+    {
+      std::vector<object> arguments {};
+
+      if (not cdr(lists))
+      {
+        for (const object& each : car(lists))
+        {
+          arguments.push_back(list(each));
+        }
+      }
+      else
+      {
+        std::vector<object> xs (kernel::begin(lists), kernel::end(lists));
+
+        while (std::all_of(std::begin(xs), std::end(xs), [](const auto& x) { return x and x.template is<pair>(); }))
+        {
+          stack operands {};
+
+          for (auto iter {std::rbegin(xs)}; iter != std::rend(xs); ++iter)
+          {
+            operands.push(car(*iter));
+            *iter = cdr(*iter);
+          }
+
+          arguments.push_back(operands);
+        }
+      }
+
+      std::vector<object> results (std::size(arguments));
+
+      parallel_for(std::size(arguments), [&](auto&& worker, auto index)
+      {
+        results[index] = worker.apply(procedure, arguments[index]);
+      });
+
+      object result {unit};
+
+      for (auto iter {std::rbegin(results)}; iter != std::rend(results); ++iter)
+      {
+        result = cons(*iter, result);
+      }
+
+      return result;
+    }
+
+    /* ------------------------------------------------------------------------
+    * (parallel-reduce procedure initial list)
+    *
+    * Combine the elements of list by procedure, which must be associative.
+    * Each chunk of list is folded left on the thread pool, then the results
+    * of chunks are folded left in order. Returns initial if list is empty.
+    *----------------------------------------------------------------------- */
+    auto parallel_reduce(const object& procedure, const object& initial, const object& xs)
+    {
+      const std::vector<object> elements (kernel::begin(xs), kernel::end(xs));
+
+      if (elements.empty())
+      {
+        return initial;
+      }
+
+      const std::size_t chunks {std::min(std::size(elements), pool().size() * 4)};
+
+      std::vector<object> results (chunks);
+
+      parallel_for(chunks, [&](auto&& worker, auto chunk)
+      {
+        const auto first {std::size(elements) * chunk / chunks},
+                   last  {std::size(elements) * (chunk + 1) / chunks};
+
+        object result {elements[first]};
+
+        for (auto index {first + 1}; index < last; ++index)
+        {
+          result = worker.apply(procedure, list(result, elements[index]));
+        }
+
+        results[chunk] = result;
+      });
+
+      /* ----------------------------------------------------------------------
+      * The virtual machine of this syntactic continuation is running the
+      * caller, so the results of chunks are combined on another one.
+      *--------------------------------------------------------------------- */
+      syntactic_continuation worker {unit, shared_environment()};
+
+      employ(worker);
+
+      object result {results.front()};
+
+      for (auto iter {std::next(std::begin(results))}; iter != std::end(results); ++iter)
+      {
+        result = worker.apply(procedure, list(result, *iter));
+      }
+
+      return result;
+    }
+
+    /* ==== Futures ===========================================================
+    *
+    * (spawn thunk) returns a future and starts evaluating thunk on the thread
+    * pool. (touch future) returns its value, rethrowing the exception if the
+    * evaluation failed. If no worker has started the future yet, the touching
+    * thread steals and evaluates it by itself; otherwise it runs other pending
+    * tasks until the future becomes ready. Touching a non-future object
+    * returns the object itself.
+    *
+    *======================================================================= */
+    auto spawn(const object& thunk)
+    {
+      const auto x {make<future>(thunk, shared_environment())};
+
+      pool().submit([this, x]()
+      {
+        run(x);
+      });
+
+      return x;
+    }
+
+    void run(const object& x)
+    {
+      if (const auto& f {x.as<const future>()}; f.claim())
+      {
+        try
+        {
+          syntactic_continuation worker {unit, f.environment()};
+
+          employ(worker);
+
+          f.resolve(worker.apply(f.procedure(), unit));
+        }
+        catch (...)
+        {
+          f.reject(std::current_exception());
+        }
+
+        pool().notify();
+      }
+    }
+
+    auto touch(const object& x)
+    {
+      if (not x or not x.is<future>())
+      {
+        return x;
+      }
+      else
+      {
+        run(x);
+
+        const auto& f {x.as<const future>()};
+
+        pool().wait_until([&]()
+        {
+          return f.ready();
+        });
+
+        return f.get();
+      }
+    }
+  };
+
+  template <>
+  syntactic_continuation::syntactic_continuation(std::integral_constant<int, 0>)
+  {
+    define<special>("quote", [&](auto&&... operands)
+    {
+      return quotation(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("quasiquote", [&](auto&&... operands)
+    {
+      return quasiquotation(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("if", [&](auto&&... operands)
+    {
+      return conditional(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("define", [&](auto&&... operands)
+    {
+      return definition(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("begin", [&](auto&&... operands)
+    {
+      return sequence(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("call-with-current-continuation", [&](auto&&... operands)
+    {
+      return call_cc(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("lambda", [&](auto&&... operands)
+    {
+      return lambda(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("environment", [&](auto&&... operands)
+    {
+      return abstraction(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("call-with-current-syntactic-continuation", [&](auto&&... operands)
+    {
+      return call_csc(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("set!", [&](auto&&... operands)
+    {
+      return assignment(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("let", [&](auto&&... operands)
+    {
+      return let(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("let*", [&](auto&&... operands)
+    {
+      return sequential_let(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("letrec", [&](auto&&... operands)
+    {
+      return recursive_let(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("letrec*", [&](auto&&... operands)
+    {
+      return recursive_let(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("and", [&](auto&&... operands)
+    {
+      return conjunction(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("or", [&](auto&&... operands)
+    {
+      return disjunction(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("cond", [&](auto&&... operands)
+    {
+      return cond(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("case", [&](auto&&... operands)
+    {
+      return case_(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("values", [&](auto&&... operands)
+    {
+      return multiple_values(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("call-with-values", [&](auto&&... operands)
+    {
+      return call_with_values(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("receive", [&](auto&&... operands)
+    {
+      return receive(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("let-values", [&](auto&&... operands)
+    {
+      return let_values(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("let*-values", [&](auto&&... operands)
+    {
+      return sequential_let_values(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("when", [&](auto&&... operands)
+    {
+      return when(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("unless", [&](auto&&... operands)
+    {
+      return unless(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("define-library", [&](auto&&... operands)
+    {
+      return define_library(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<special>("import", [&](auto&&... operands)
+    {
+      return import(std::forward<decltype(operands)>(operands)...);
+    });
+
+    define<procedure>("load", [&](const object& operands)
+    {
+      reenter("load");
+      return load(car(operands).as<const string>());
+    });
+
+    define<procedure>("command-line", [&](auto&&)
+    {
+      return command_line;
+    });
+
+    define<procedure>("compile-file", [&](const object& operands)
+    {
+      reenter("compile-file");
+
+      const std::string cache {compile_file(car(operands).as<const string>())};
+
+      object result {unit};
+
+      for (auto iter {std::rbegin(cache)}; iter != std::rend(cache); ++iter)
+      {
+        result = make<string>(make<character>(*iter), result);
+      }
+
+      return result;
+    });
+
+    define<procedure>("linker", [&](auto&& operands)
+    {
+      if (auto size {length(operands)}; size < 1)
+      {
+        throw evaluation_error {
+          "procedure linker expects a string for argument, but received nothing."
+        };
+      }
+      else if (const object& s {car(operands)}; not s.is<string>())
+      {
+        throw evaluation_error {
+          "procedure linker expects a string for argument, but received ",
+          meevax::utility::demangle(s.type()),
+          " rest ", size, " argument",
+          (size < 2 ? " " : "s "),
+          "were ignored."
+        };
+      }
+      else
+      {
+        return make<meevax::posix::linker>(s.as<string>(), verbose_linker);
+      }
+    });
+
+    define<procedure>("native", [&](const homoiconic_iterator& operands)
+    {
+      // if (auto size {length(operands)}; size < 1)
+      // {
+      //   throw evaluation_error {
       //     "procedure link expects two arguments (linker and string), but received nothing."
       //   };
       // }
@@ -557,12 +1601,14 @@ namespace meevax::kernel
         return
           make<procedure>(
             name,
-            car(operands).as<posix::linker>().link<procedure::signature>(name));
+            posix::symbol {car(operands), name});
       // }
     });
 
     define<procedure>("read", [&](const homoiconic_iterator& operands)
     {
+      reenter("read");
+
       return read(operands ? car(operands).as<input_file>() : std::cin);
     });
 
@@ -574,43 +1620,78 @@ namespace meevax::kernel
 
     define<procedure>("evaluate", [&](auto&& operands)
     {
-      return evaluate(car(operands));
+      /* ----------------------------------------------------------------------
+      * The procedure is called while the machine is running, so the running
+      * state has to be dumped before re-entering and restored after it.
+      *--------------------------------------------------------------------- */
+      reenter("evaluate");
+
+      d.push(s, e, c);
+      s = e = c = unit;
+
+      const auto result {evaluate(car(operands))};
+
+      s = d.pop();
+      e = d.pop();
+      c = d.pop();
+
+      return result;
     });
-  } // syntactic_continuation class default constructor
 
-  template <>
-  syntactic_continuation::syntactic_continuation(std::integral_constant<int, 1>)
-    : syntactic_continuation::syntactic_continuation {layer<0>}
-  {
-    static const std::string layer_1 {
-      &_binary_layer_1_ss_start, &_binary_layer_1_ss_end
-    };
-    // std::cerr << layer_1 << std::endl;
+    define<procedure>("macroexpand-statistics", [&](auto&&)
+    {
+      return list(
+               cons(intern("hits"), make<real>(transformer::expansion_hits.load())),
+               cons(intern("misses"), make<real>(transformer::expansion_misses.load())),
+               cons(intern("nanoseconds"), make<real>(transformer::expansion_nanoseconds.load())));
+    });
 
-    std::stringstream stream {layer_1};
+    define<procedure>("definition-statistics", [&](auto&&)
+    {
+      return list(
+               cons(intern("deferred"), make<real>(stub::deferred.load())),
+               cons(intern("materialized"), make<real>(stub::materialized.load())));
+    });
 
-    std::size_t loaded {0};
+    define<procedure>("frame-statistics", [&](auto&&)
+    {
+      return list(
+               cons(intern("recycled"), make<real>(frames_recycled)),
+               cons(intern("reused"), make<real>(frames_reused)));
+    });
 
-    for (auto e {read(stream)}; e != characters.at("end-of-file"); e = read(stream))
+    define<procedure>("parallel-map", [&](const object& operands)
     {
-      // if (verbose == true_object or verbose_environment == true_object)
-      // {
-        std::cerr << "; layer 1\t; " << loaded << " expression loaded";
-      // }
+      return parallel_map(car(operands), cdr(operands));
+    });
 
-      evaluate(e);
+    define<procedure>("parallel-for-each", [&](const object& operands)
+    {
+      parallel_map(car(operands), cdr(operands));
+      return unspecified;
+    });
 
-      // if (verbose == true_object or verbose_environment == true_object)
-      // {
-        ++loaded;
-        std::cerr << "\r" << std::flush;
-      // }
-    }
+    define<procedure>("parallel-reduce", [&](const object& operands)
+    {
+      return parallel_reduce(car(operands), cadr(operands), caddr(operands));
+    });
 
-    // if (verbose == true_object or verbose_environment == true_object)
-    // {
-      std::cerr << std::endl;
-    // }
+    define<procedure>("spawn", [&](const object& operands)
+    {
+      return spawn(car(operands));
+    });
+
+    define<procedure>("touch", [&](const object& operands)
+    {
+      return touch(car(operands));
+    });
+  } // syntactic_continuation class default constructor
+
+  template <>
+  syntactic_continuation::syntactic_continuation(std::integral_constant<int, 1>)
+    : syntactic_continuation::syntactic_continuation {layer<0>}
+  {
+    boot();
   }
 
   std::ostream& operator<<(std::ostream& os, const syntactic_continuation& syntactic_continuation)
@@ -0,0 +1,216 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_THREAD_POOL_HPP
+#define INCLUDED_MEEVAX_KERNEL_THREAD_POOL_HPP
+
+#include <algorithm> // std::max
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Work-Stealing Thread Pool
+  *
+  *   Each worker has its own task queue. A worker pushes and pops tasks at the
+  *   back of its own queue (LIFO, for locality), and steals tasks from the
+  *   front of the other workers' queues (FIFO) when its own queue is empty.
+  *   Tasks submitted from outside of the pool are distributed round-robin.
+  *
+  *   A thread waiting for the completion of tasks should call "wait_until"
+  *   (which runs pending tasks while waiting, and sleeps only if there is no
+  *   pending task) instead of blocking, so that nested parallelism never
+  *   deadlocks.
+  *
+  *   Tasks must not throw. Callers are responsible for transporting exceptions
+  *   (by std::exception_ptr) to the waiting thread.
+  *
+  *========================================================================= */
+  class thread_pool
+  {
+  public:
+    using task = std::function<void ()>;
+
+  private:
+    struct queue
+    {
+      std::mutex mutex;
+
+      std::deque<task> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues;
+
+    std::vector<std::thread> workers;
+
+    std::atomic<std::size_t> pending {0}, next {0};
+
+    std::mutex mutex; // for sleeping workers
+
+    std::condition_variable condition, completion;
+
+    bool done {false};
+
+    static inline thread_local const thread_pool* owner {nullptr};
+
+    static inline thread_local std::size_t index {0};
+
+  public:
+    explicit thread_pool(std::size_t size = std::thread::hardware_concurrency())
+    {
+      size = std::max<std::size_t>(size, 1);
+
+      for (std::size_t k {0}; k < size; ++k)
+      {
+        queues.emplace_back(std::make_unique<queue>());
+      }
+
+      for (std::size_t k {0}; k < size; ++k)
+      {
+        workers.emplace_back([this, k]()
+        {
+          owner = this;
+          index = k;
+          work();
+        });
+      }
+    }
+
+    ~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock {mutex};
+        done = true;
+      }
+
+      condition.notify_all();
+
+      for (auto&& each : workers)
+      {
+        each.join();
+      }
+    }
+
+    auto size() const noexcept
+    {
+      return std::size(queues); // NOTE: workers is still growing while the first workers start
+    }
+
+    void submit(task&& t)
+    {
+      {
+        std::lock_guard<std::mutex> lock {mutex};
+        ++pending;
+      }
+
+      auto& target {*queues[owner == this ? index : next++ % size()]};
+
+      {
+        std::lock_guard<std::mutex> lock {target.mutex};
+        target.tasks.push_back(std::move(t));
+      }
+
+      condition.notify_one();
+    }
+
+    bool run_pending_task()
+    {
+      if (task t {}; pop(t))
+      {
+        t();
+        notify();
+        return true;
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    // Wake up threads in "wait_until" to re-check their predicates.
+    void notify()
+    {
+      {
+        std::lock_guard<std::mutex> lock {mutex};
+      }
+
+      completion.notify_all();
+    }
+
+    template <typename Predicate>
+    void wait_until(Predicate&& ready)
+    {
+      while (not ready())
+      {
+        if (not run_pending_task())
+        {
+          std::unique_lock<std::mutex> lock {mutex};
+
+          completion.wait(lock, [&]()
+          {
+            return ready() or 0 < pending;
+          });
+        }
+      }
+    }
+
+  private:
+    bool pop(task& t)
+    {
+      const std::size_t self {owner == this ? index : next % size()};
+
+      for (std::size_t k {0}; k < size(); ++k)
+      {
+        auto& each {*queues[(self + k) % size()]};
+
+        std::lock_guard<std::mutex> lock {each.mutex};
+
+        if (not each.tasks.empty())
+        {
+          if (k == 0 and owner == this) // pop own task
+          {
+            t = std::move(each.tasks.back());
+            each.tasks.pop_back();
+          }
+          else // steal
+          {
+            t = std::move(each.tasks.front());
+            each.tasks.pop_front();
+          }
+
+          --pending;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    void work()
+    {
+      while (true)
+      {
+        if (not run_pending_task())
+        {
+          std::unique_lock<std::mutex> lock {mutex};
+
+          condition.wait(lock, [this]()
+          {
+            return done or 0 < pending;
+          });
+
+          if (done and pending == 0)
+          {
+            return;
+          }
+        }
+      }
+    }
+  };
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_THREAD_POOL_HPP
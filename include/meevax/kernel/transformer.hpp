@@ -0,0 +1,124 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_TRANSFORMER_HPP
+#define INCLUDED_MEEVAX_KERNEL_TRANSFORMER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+#include <meevax/kernel/list.hpp>
+#include <meevax/kernel/symbol.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * The transformer is a pair of the closure of a macro (or an environment)
+  * and the global environment when it constructed, made by instruction
+  * MAKE_SYNTACTIC_CONTINUATION and MAKE_ENVIRONMENT.
+  *
+  * Unlike syntactic_continuation, a transformer has no reader, virtual
+  * machine, configuration and symbol table of its own. The machine which
+  * compiles the macro use runs the closure on behalf of the transformer (see
+  * machine::expand).
+  *========================================================================= */
+  struct transformer
+    : public virtual pair
+  {
+    template <typename... Ts>
+    explicit transformer(Ts&&... operands)
+      : pair {std::forward<decltype(operands)>(operands)...}
+    {}
+
+    /* ------------------------------------------------------------------------
+    * Implicit renaming. When the closure evaluates an undefined variable, it
+    * receives an uninterned symbol which is shared by the same expansion,
+    * but never collides with symbols of the other expansions and of the
+    * user. Workers may expand the same macro at once, so each expansion has
+    * the renamings of its own (see machine::expand).
+    *----------------------------------------------------------------------- */
+    std::atomic<std::size_t> time_stamp {0};
+
+    std::unordered_map<const pair*, object> renamings;
+
+    const auto& rename(const object& x)
+    {
+      if (auto iter {renamings.find(x.get())}; iter != std::end(renamings))
+      {
+        return iter->second;
+      }
+      else
+      {
+        const std::string name {
+          x.as<const std::string>() + "." + std::to_string(time_stamp)
+        };
+
+        return renamings.emplace(x.get(), make<symbol>(name)).first->second;
+      }
+    }
+
+    /* ========================================================================
+    * Expansion Cache
+    *
+    *   Each macro memoizes its expansions keyed by the identity (eq?) of the
+    *   macro use. Recompiling the same code (e.g. evaluate of the same datum
+    *   in a loop) then skips running the transformer, and so do the macro
+    *   uses in a cached expansion, which are the same pairs each time.
+    *
+    *   Macro uses which are only equal? are expanded separately, since an
+    *   unhygienic transformer may have side effects or depend on the state
+    *   at expansion time. A redefined macro is a new transformer with an
+    *   empty cache, so stale expansions are never seen through the new
+    *   binding.
+    *
+    *======================================================================= */
+    static inline std::size_t expansion_cache_size {1024};
+
+    static inline std::atomic<std::size_t> expansion_hits {0},
+                                           expansion_misses {0},
+                                           expansion_nanoseconds {0};
+
+    // The form is kept, so that its address is never reused while cached.
+    std::unordered_map<const pair*, std::pair<const object, const object>> expansions;
+
+    std::mutex expansions_mutex;
+
+    object lookup(const object& form)
+    {
+      const std::lock_guard<std::mutex> lock {expansions_mutex};
+
+      if (auto iter {expansions.find(form.get())}; iter != std::end(expansions))
+      {
+        ++expansion_hits;
+        return iter->second.second;
+      }
+      else
+      {
+        ++expansion_misses;
+        return unit;
+      }
+    }
+
+    void memoize(const object& form, const object& expansion)
+    {
+      const std::lock_guard<std::mutex> lock {expansions_mutex};
+
+      if (expansion_cache_size <= std::size(expansions))
+      {
+        expansions.clear();
+      }
+
+      expansions.emplace(form.get(), std::make_pair(form, expansion));
+    }
+  };
+
+  std::ostream& operator<<(std::ostream& os, const transformer& transformer)
+  {
+    return os << highlight::syntax << "#("
+              << highlight::constructor << "transformer"
+              << attribute::normal << highlight::comment << " #;" << &transformer << attribute::normal
+              << highlight::syntax << ")"
+              << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_TRANSFORMER_HPP
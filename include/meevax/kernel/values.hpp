@@ -0,0 +1,35 @@
+#ifndef INCLUDED_MEEVAX_KERNEL_VALUES_HPP
+#define INCLUDED_MEEVAX_KERNEL_VALUES_HPP
+
+#include <meevax/kernel/pair.hpp>
+
+namespace meevax::kernel
+{
+  /* ==========================================================================
+  * Multiple values other than one, made by instruction VALUES and by the
+  * application of a continuation. The car is the list of the values, which
+  * instruction CALL_WITH_VALUES passes to the consumer as its operands.
+  *========================================================================= */
+  struct values
+    : public virtual pair
+  {
+    template <typename... Ts>
+    explicit values(Ts&&... operands)
+      : pair {std::forward<decltype(operands)>(operands)...}
+    {}
+  };
+
+  std::ostream& operator<<(std::ostream& os, const values& values)
+  {
+    os << highlight::syntax << "#(" << highlight::constructor << "values" << attribute::normal;
+
+    for (auto each {std::get<0>(values)}; each; each = cdr(each))
+    {
+      os << " " << car(each);
+    }
+
+    return os << highlight::syntax << ")" << attribute::normal;
+  }
+} // namespace meevax::kernel
+
+#endif // INCLUDED_MEEVAX_KERNEL_VALUES_HPP
@@ -0,0 +1,141 @@
+#ifndef INCLUDED_MEEVAX_POSIX_EXECUTABLE_HPP
+#define INCLUDED_MEEVAX_POSIX_EXECUTABLE_HPP
+
+#include <cerrno>
+#include <climits> // PATH_MAX
+#include <cstdio> // std::remove
+#include <cstdlib> // std::getenv
+#include <cstring> // std::memcmp
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <elf.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace meevax::posix
+{
+  /**
+   * Standalone executables (see "--build-executable") are copies of the
+   * running executable with the program image added as a section by objcopy
+   * (as the layers are embedded at build time, see CMakeLists.txt). A section
+   * added to a linked executable is not loaded into memory, so it is read
+   * from the file through the section header table.
+   */
+  static constexpr auto program_section {".meevax.program"};
+
+  /**
+   * Return the contents of the named section of the ELF file, or the empty
+   * string if there is no such section (or the file is not a 64-bit ELF).
+   */
+  inline auto section(const std::string& path, const std::string& name)
+  {
+    std::ifstream file {path, std::ios::binary};
+
+    ::Elf64_Ehdr header {};
+
+    if (not file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        or std::memcmp(header.e_ident, ELFMAG, SELFMAG)
+        or header.e_ident[EI_CLASS] != ELFCLASS64
+        or header.e_shentsize != sizeof(::Elf64_Shdr)
+        or header.e_shnum <= header.e_shstrndx)
+    {
+      return std::string {};
+    }
+
+    std::vector<::Elf64_Shdr> sections (header.e_shnum);
+
+    if (not file.seekg(header.e_shoff)
+        or not file.read(reinterpret_cast<char*>(sections.data()), sizeof(::Elf64_Shdr) * std::size(sections)))
+    {
+      return std::string {};
+    }
+
+    auto contents = [&](const ::Elf64_Shdr& section)
+    {
+      std::string buffer (section.sh_size, '\0');
+
+      if (not file.seekg(section.sh_offset) or not file.read(buffer.data(), std::size(buffer)))
+      {
+        buffer.clear();
+      }
+
+      return buffer;
+    };
+
+    const auto names {contents(sections[header.e_shstrndx])};
+
+    for (const auto& each : sections)
+    {
+      if (each.sh_name < std::size(names) and name == names.c_str() + each.sh_name)
+      {
+        return contents(each);
+      }
+    }
+
+    return std::string {};
+  }
+
+  /**
+   * Write a copy of the running executable to the output path, with the
+   * contents added as the program section. The objcopy to run is given by
+   * the environment variable OBJCOPY (defaults to "objcopy").
+   */
+  inline void embed(const std::string& output, const std::string& contents)
+  {
+    const auto temporary {output + ".section"};
+
+    if (std::ofstream port {temporary, std::ios::binary}; not port or not port.write(contents.data(), std::size(contents)))
+    {
+      throw std::system_error {errno, std::system_category(), temporary};
+    }
+
+    char executable[PATH_MAX] {};
+
+    if (::readlink("/proc/self/exe", executable, sizeof(executable) - 1) < 0) // not of the child
+    {
+      throw std::system_error {errno, std::system_category(), "readlink /proc/self/exe"};
+    }
+
+    const std::string objcopy {std::getenv("OBJCOPY") ? std::getenv("OBJCOPY") : "objcopy"};
+
+    const auto added {std::string {program_section} + "=" + temporary};
+
+    const auto flags {std::string {program_section} + "=noload,readonly"};
+
+    const char* const argv[] {
+      objcopy.c_str(),
+      "--add-section", added.c_str(),
+      "--set-section-flags", flags.c_str(),
+      executable, output.c_str(),
+      nullptr
+    };
+
+    ::pid_t pid {};
+
+    int status {0};
+
+    if (const auto error {::posix_spawnp(&pid, objcopy.c_str(), nullptr, nullptr, const_cast<char* const*>(argv), environ)}; error)
+    {
+      std::remove(temporary.c_str());
+      throw std::system_error {error, std::system_category(), objcopy};
+    }
+
+    while (::waitpid(pid, &status, 0) < 0 and errno == EINTR);
+
+    std::remove(temporary.c_str());
+
+    if (not WIFEXITED(status) or WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+      throw std::runtime_error {objcopy + " failed to write " + output};
+    }
+  }
+} // namespace meevax::posix
+
+#endif // INCLUDED_MEEVAX_POSIX_EXECUTABLE_HPP
@@ -0,0 +1,378 @@
+#ifndef INCLUDED_MEEVAX_POSIX_FORK_SERVER_HPP
+#define INCLUDED_MEEVAX_POSIX_FORK_SERVER_HPP
+
+#include <array>
+#include <cerrno>
+#include <climits> // PATH_MAX
+#include <csignal>
+#include <cstring> // std::memcpy, std::strerror
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace meevax::posix
+{
+  /**
+   * Unix domain socket of the fork server and its clients.
+   *
+   * A request is a message whose data is the working directory of the client
+   * and whose ancillary data is the standard input, output and error of the
+   * client (SCM_RIGHTS). The reply is the exit status of the process which
+   * served the request.
+   */
+  struct socket
+  {
+    const int descriptor;
+
+    explicit socket(int descriptor)
+      : descriptor {descriptor}
+    {
+      if (descriptor < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "socket"};
+      }
+    }
+
+    socket()
+      : socket {::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)}
+    {}
+
+    socket(const socket&) = delete;
+
+    socket& operator=(const socket&) = delete;
+
+    ~socket()
+    {
+      ::close(descriptor);
+    }
+
+    static auto address(const std::string& path)
+    {
+      ::sockaddr_un address {};
+
+      address.sun_family = AF_UNIX;
+
+      if (sizeof(address.sun_path) <= path.size())
+      {
+        throw std::system_error {ENAMETOOLONG, std::system_category(), path};
+      }
+
+      std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+      return address;
+    }
+
+    static constexpr std::size_t descriptors {3}; // stdin, stdout, stderr
+
+    union ancillary
+    {
+      char buffer[CMSG_SPACE(sizeof(int) * descriptors)];
+      ::cmsghdr align;
+    };
+
+    void send_request(const std::string& directory) const
+    {
+      ::iovec data {const_cast<char*>(directory.c_str()), directory.size() + 1};
+
+      ancillary control {};
+
+      ::msghdr message {};
+      message.msg_iov = &data;
+      message.msg_iovlen = 1;
+      message.msg_control = control.buffer;
+      message.msg_controllen = sizeof(control.buffer);
+
+      auto* header {CMSG_FIRSTHDR(&message)};
+      header->cmsg_level = SOL_SOCKET;
+      header->cmsg_type = SCM_RIGHTS;
+      header->cmsg_len = CMSG_LEN(sizeof(int) * descriptors);
+
+      const int standard[descriptors] {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+      std::memcpy(CMSG_DATA(header), standard, sizeof(standard));
+
+      if (::sendmsg(descriptor, &message, 0) < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "sendmsg"};
+      }
+    }
+
+    auto receive_request(std::array<int, descriptors>& received) const
+    {
+      char directory[PATH_MAX] {};
+
+      ::iovec data {directory, sizeof(directory) - 1};
+
+      ancillary control {};
+
+      ::msghdr message {};
+      message.msg_iov = &data;
+      message.msg_iovlen = 1;
+      message.msg_control = control.buffer;
+      message.msg_controllen = sizeof(control.buffer);
+
+      if (::recvmsg(descriptor, &message, MSG_CMSG_CLOEXEC) < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "recvmsg"};
+      }
+
+      const auto* header {CMSG_FIRSTHDR(&message)};
+
+      if (not header or header->cmsg_type != SCM_RIGHTS or header->cmsg_len != CMSG_LEN(sizeof(int) * descriptors))
+      {
+        throw std::system_error {EPROTO, std::system_category(), "request without standard streams"};
+      }
+
+      std::memcpy(received.data(), CMSG_DATA(header), sizeof(int) * descriptors);
+
+      return std::string {directory};
+    }
+  };
+
+  /**
+   * The fork server boots once, and serves each request by a copy-on-write
+   * child process of the booted interpreter (so the child starts without
+   * booting layer 1). The child takes the standard streams of the client,
+   * and evaluates its standard input as the interpreter does.
+   *
+   * Only the parent listens. "serve" returns in each child, and never in the
+   * parent.
+   */
+  class fork_server
+  {
+    const std::string path;
+
+    const posix::socket listener {};
+
+    std::unordered_map<::pid_t, int> connections {}; // of running children
+
+    static inline int wakeup[2] {-1, -1}; // self-pipe written on SIGCHLD
+
+    const ::pid_t parent {::getpid()};
+
+    /*
+     * Requests are received in the accept loop, so a client which connects
+     * and sends nothing must not keep the others waiting longer than this.
+     */
+    static constexpr ::timeval receive_timeout {1, 0};
+
+    static void notify(int)
+    {
+      const auto saved {errno};
+      [[maybe_unused]] const auto result {::write(wakeup[1], "", 1)};
+      errno = saved;
+    }
+
+    void reap()
+    {
+      char buffer[64];
+
+      while (0 < ::read(wakeup[0], buffer, sizeof(buffer)));
+
+      for (int status {0}; ; )
+      {
+        const auto pid {::waitpid(-1, &status, WNOHANG)};
+
+        if (pid <= 0)
+        {
+          break;
+        }
+        else if (auto iter {connections.find(pid)}; iter != std::end(connections))
+        {
+          const int code {WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)};
+          [[maybe_unused]] const auto result {::send(iter->second, &code, sizeof(code), MSG_NOSIGNAL)}; // the client may be gone
+          ::close(iter->second);
+          connections.erase(iter);
+        }
+      }
+    }
+
+  public:
+    explicit fork_server(const std::string& path)
+      : path {path}
+    {
+      const auto address {socket::address(path)};
+
+      ::unlink(path.c_str());
+
+      if (::bind(listener.descriptor, reinterpret_cast<const ::sockaddr*>(&address), sizeof(address)) < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "bind " + path};
+      }
+      else if (::listen(listener.descriptor, SOMAXCONN) < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "listen " + path};
+      }
+      else if (::pipe2(wakeup, O_CLOEXEC | O_NONBLOCK) < 0)
+      {
+        throw std::system_error {errno, std::system_category(), "pipe"};
+      }
+
+      struct ::sigaction action {};
+      action.sa_handler = notify;
+      action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+      ::sigaction(SIGCHLD, &action, nullptr);
+    }
+
+    ~fork_server()
+    {
+      ::close(wakeup[0]);
+      ::close(wakeup[1]);
+
+      if (::getpid() == parent)
+      {
+        ::unlink(path.c_str());
+      }
+    }
+
+    void serve()
+    {
+      for (::pollfd events[2] {{listener.descriptor, POLLIN, 0}, {wakeup[0], POLLIN, 0}}; ; )
+      {
+        if (::poll(events, 2, -1) < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+
+          throw std::system_error {errno, std::system_category(), "poll"};
+        }
+
+        if (events[1].revents & POLLIN)
+        {
+          reap();
+        }
+
+        if (not (events[0].revents & POLLIN))
+        {
+          continue;
+        }
+
+        const int connection {::accept4(listener.descriptor, nullptr, nullptr, SOCK_CLOEXEC)};
+
+        if (connection < 0)
+        {
+          continue;
+        }
+
+        std::array<int, socket::descriptors> streams {-1, -1, -1};
+
+        std::string directory {};
+
+        try
+        {
+          if (::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout)) < 0)
+          {
+            throw std::system_error {errno, std::system_category(), "setsockopt"};
+          }
+
+          directory = socket {::dup(connection)}.receive_request(streams);
+        }
+        catch (const std::system_error& error)
+        {
+          std::cerr << "; server\t; " << error.what() << std::endl;
+          ::close(connection);
+          continue;
+        }
+
+        std::cout << std::flush;
+        std::cerr << std::flush;
+
+        if (const auto pid {::fork()}; pid < 0)
+        {
+          std::cerr << "; server\t; fork: " << std::strerror(errno) << std::endl;
+          ::close(connection);
+        }
+        else if (pid == 0) // child
+        {
+          ::signal(SIGCHLD, SIG_DFL);
+
+          for (const auto& [pid, each] : connections)
+          {
+            ::close(each);
+          }
+
+          ::close(connection);
+
+          for (std::size_t index {0}; index < socket::descriptors; ++index)
+          {
+            ::dup2(streams[index], index);
+            ::close(streams[index]);
+          }
+
+          if (::chdir(directory.c_str()) < 0)
+          {
+            std::cerr << "; server\t; chdir " << directory << ": " << std::strerror(errno) << std::endl;
+          }
+
+          return;
+        }
+        else
+        {
+          connections.emplace(pid, connection);
+        }
+
+        for (const auto each : streams)
+        {
+          ::close(each);
+        }
+      }
+    }
+  };
+
+  /**
+   * Evaluate the standard input on the fork server, and return the exit
+   * status of the child process which served it.
+   */
+  inline int request(const std::string& path)
+  {
+    const posix::socket client {};
+
+    const auto address {socket::address(path)};
+
+    if (::connect(client.descriptor, reinterpret_cast<const ::sockaddr*>(&address), sizeof(address)) < 0)
+    {
+      throw std::system_error {errno, std::system_category(), "connect " + path};
+    }
+
+    char directory[PATH_MAX] {};
+
+    if (not ::getcwd(directory, sizeof(directory)))
+    {
+      throw std::system_error {errno, std::system_category(), "getcwd"};
+    }
+
+    client.send_request(directory);
+
+    int status {EXIT_FAILURE};
+
+    for (std::size_t size {0}; size < sizeof(status); )
+    {
+      if (const auto result {::read(client.descriptor, reinterpret_cast<char*>(&status) + size, sizeof(status) - size)}; 0 < result)
+      {
+        size += result;
+      }
+      else if (result < 0 and errno == EINTR)
+      {
+        continue;
+      }
+      else
+      {
+        return EXIT_FAILURE; // the server exited
+      }
+    }
+
+    return status;
+  }
+} // namespace meevax::posix
+
+#endif // INCLUDED_MEEVAX_POSIX_FORK_SERVER_HPP
@@ -2,22 +2,23 @@
 #define INCLUDED_MEEVAX_POSIX_LINKER_HPP
 
 #include <iostream>
-#include <memory> // std::unique_ptr
+#include <memory> // std::shared_ptr
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include <dlfcn.h> // dlopen, dlclose, dlerror
 
+#include <meevax/kernel/boolean.hpp>
+#include <meevax/kernel/builtin.hpp>
+#include <meevax/kernel/exception.hpp>
+#include <meevax/kernel/procedure.hpp>
 #include <meevax/utility/demangle.hpp>
 
 namespace meevax::posix
 {
-  inline namespace dirty_hacks
-  {
-    kernel::object verbose_linker {kernel::false_object};
-  }
-
   #define VERBOSE_LINKER(...)                                                  \
-  if (verbose_linker == kernel::true_object)                                   \
+  if (verbose == kernel::true_object)                                          \
   {                                                                            \
     std::cerr << __VA_ARGS__;                                                  \
   }
@@ -34,6 +35,8 @@ namespace meevax::posix
     {
       const std::string path;
 
+      const kernel::object verbose;
+
       void operator()(void* handle) noexcept
       {
         VERBOSE_LINKER("; linker\t; closing shared library \"" << path << "\" => ");
@@ -51,37 +54,74 @@ namespace meevax::posix
 
     std::string path_;
 
-    std::unique_ptr<void, close> handle_;
+    /**
+     * Verbosity is held by each linker (copied from the configuration of the
+     * syntactic_continuation that opened it) instead of a global variable.
+     */
+    const kernel::object verbose;
+
+    /**
+     * Handles are shared by every linker of the same path in the process,
+     * and opened by the first link through any of them (so a library whose
+     * procedures are never applied is never loaded).
+     */
+    static inline std::mutex mutex {};
+
+    static inline std::unordered_map<std::string, std::weak_ptr<void>> handles {};
+
+    mutable std::shared_ptr<void> handle_;
 
   public:
-    auto open(const std::string& path = "")
+    auto open() const
     {
-      VERBOSE_LINKER("; linker\t; opening shared library \"" << path << "\" => ");
+      const std::lock_guard<std::mutex> lock {mutex};
+
+      if (handle_)
+      {
+        return handle_;
+      }
+      else if (auto iter {handles.find(path_)}; iter != std::end(handles))
+      {
+        if (auto shared {iter->second.lock()}; shared)
+        {
+          return handle_ = shared;
+        }
+      }
+
+      VERBOSE_LINKER("; linker\t; opening shared library \"" << path_ << "\" => ");
 
       dlerror(); // clear
 
-      std::unique_ptr<void, close> buffer {
-        dlopen(path.empty() ? nullptr : path.c_str(), RTLD_LAZY),
-        close {path}
+      /*
+       * Objects made by a shared library (e.g. the results of its procedures)
+       * may outlive the linker, and their destructors and control blocks of
+       * std::shared_ptr are code of the library. So the library is never
+       * unloaded by dlclose.
+       */
+      std::shared_ptr<void> buffer {
+        dlopen(path_.empty() ? nullptr : path_.c_str(), RTLD_LAZY | RTLD_NODELETE),
+        close {path_, verbose}
       };
 
       if (auto* message {dlerror()}; message)
       {
         VERBOSE_LINKER("failed to open shared library " << message << std::endl);
-        std::exit(EXIT_FAILURE);
+        throw kernel::evaluation_error {"failed to open shared library ", message};
       }
       else
       {
         VERBOSE_LINKER("succeeded." << std::endl);
-        path_ = path;
       }
 
-      return buffer;
+      handles[path_] = buffer;
+
+      return handle_ = buffer;
     }
 
-    linker(const std::string& path = "")
+    linker(const std::string& path = "",
+           const kernel::object& verbose = kernel::false_object)
       : path_ {path}
-      , handle_ {open(path)}
+      , verbose {verbose}
     {}
 
     operator bool() const noexcept
@@ -89,40 +129,116 @@ namespace meevax::posix
       return static_cast<bool>(handle_);
     }
 
+    const auto& path() const noexcept
+    {
+      return path_;
+    }
+
+    auto handle() const noexcept // null unless opened
+    {
+      return handle_.get();
+    }
+
+    /**
+     * The entry of the builtin table (see kernel/builtin.hpp), if the symbol
+     * is compiled into the kernel.
+     */
+    const kernel::builtin* builtin(const std::string& name) const
+    {
+      const auto key {path_.substr(path_.rfind('/') + 1) + " " + name}; // file name
+
+      if (auto iter {kernel::builtins.find(key)}; iter != std::end(kernel::builtins))
+      {
+        return &iter->second;
+      }
+      else
+      {
+        return nullptr;
+      }
+    }
+
     template <typename Signature>
     Signature link(const std::string& name) const
     {
-      // std::cerr << "; linker\t; linking symbol \"" << name << "\" in shared library \"" << path_ << "\" as signature " << utility::demangle(typeid(Signature)) << " => ";
+      if (const auto* entry {builtin(name)}; entry)
+      {
+        VERBOSE_LINKER("; linker\t; linking symbol \"" << name << "\" in builtin library \"" << path_ << "\"" << std::endl);
+        return reinterpret_cast<Signature>(entry->function);
+      }
+
+      const auto handle {open()};
+
       VERBOSE_LINKER("; linker\t; linking symbol \"" << name << "\" in shared library \"" << path_ << " => ");
 
-      if (handle_)
-      {
-        dlerror(); // clear
+      dlerror(); // clear
 
-        if (void* function {dlsym(handle_.get(), name.c_str())}; function)
-        {
-          VERBOSE_LINKER("succeeded." << std::endl);
+      if (void* function {dlsym(handle.get(), name.c_str())}; function)
+      {
+        VERBOSE_LINKER("succeeded." << std::endl);
 
-          // XXX Result of this cast is undefined (maybe works fine).
-          return reinterpret_cast<Signature>(function);
-        }
-        else if (auto* message {dlerror()}; message)
-        {
-          VERBOSE_LINKER("failed to link symbol, " << message << std::endl);
-          std::exit(EXIT_FAILURE);
-        }
-        else
-        {
-          VERBOSE_LINKER("failed to link symbol in unexpected situation." << std::endl);
-          std::exit(EXIT_FAILURE);
-        }
+        // XXX Result of this cast is undefined (maybe works fine).
+        return reinterpret_cast<Signature>(function);
+      }
+      else if (auto* message {dlerror()}; message)
+      {
+        VERBOSE_LINKER("failed to link symbol, " << message << std::endl);
+        throw kernel::evaluation_error {"failed to link symbol ", message};
       }
       else
       {
-        VERBOSE_LINKER(" shared library is not opened." << std::endl);
+        VERBOSE_LINKER("failed to link symbol in unexpected situation." << std::endl);
+        throw kernel::evaluation_error {"failed to link symbol ", name, " (null)"};
+      }
+    }
+  };
+
+  /**
+   * A procedure of the shared library, which is linked by its first
+   * application. If the link fails, the application raises an error and the
+   * next one tries again.
+   */
+  struct symbol
+  {
+    const kernel::object linker;
+
+    const std::string name;
+
+    struct linkage
+    {
+      std::once_flag flag;
+
+      kernel::procedure::signature function {nullptr};
+
+      const kernel::builtin* builtin {nullptr}; // to check the arity
+    };
+
+    std::shared_ptr<linkage> linked {std::make_shared<linkage>()};
+
+    void link() const
+    {
+      std::call_once(linked->flag, [this]()
+      {
+        linked->function = linker.as<posix::linker>().template link<kernel::procedure::signature>(name);
+        linked->builtin = linker.as<posix::linker>().builtin(name);
+      });
+    }
+
+    PROCEDURE(operator()) const
+    {
+      link();
+
+      if (const auto* builtin {linked->builtin}; builtin)
+      {
+        if (const std::size_t size = kernel::length(operands);
+            size < builtin->arity or (builtin->arity < size and not builtin->variadic))
+        {
+          throw kernel::evaluation_error {
+            "procedure ", name, " expects ", builtin->arity, (builtin->variadic ? " or more" : ""), " operands, but received ", size
+          };
+        }
       }
 
-      return nullptr;
+      return (*linked->function)(operands);
     }
   };
 } // namespace meevax::posix
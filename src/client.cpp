@@ -0,0 +1,31 @@
+#include <iostream>
+
+#include <boost/cstdlib.hpp> // boost::exit_failure
+
+#include <meevax/posix/fork_server.hpp>
+
+/* ============================================================================
+*
+* Client of the fork server (see "--server"), which is "meevax --client" but
+* without the kernel, so that it starts as fast as possible.
+*
+*   Usage: meevax-client SOCKET < script.ss
+*
+*========================================================================== */
+int main(const int argc, char const* const* const argv) try
+{
+  if (argc < 2)
+  {
+    std::cerr << "usage: " << argv[0] << " SOCKET" << std::endl;
+    return boost::exit_failure;
+  }
+  else
+  {
+    return meevax::posix::request(argv[1]);
+  }
+}
+catch (const std::exception& error)
+{
+  std::cerr << argv[0] << ": " << error.what() << std::endl;
+  return boost::exit_failure;
+}
@@ -1,10 +1,34 @@
 #include <meevax/kernel/boolean.hpp>
+#include <meevax/kernel/builtin.hpp>
 #include <meevax/kernel/character.hpp>
 #include <meevax/kernel/exception.hpp>
 #include <meevax/kernel/pair.hpp>
 
+#ifdef MEEVAX_BUILTIN_LIBRARIES
+#include "../library/character.cpp"
+#include "../library/equivalence.cpp"
+#include "../library/experimental.cpp"
+#include "../library/io.cpp"
+#include "../library/numerical.cpp"
+#include "../library/pair.cpp"
+#include "../library/string.cpp"
+#include "../library/symbol.cpp"
+#include "../library/vector.cpp"
+#endif
+
 namespace meevax::kernel
 {
+  /* ==========================================================================
+  * Kernel Constants
+  *
+  * These objects are constructed once before "main" and shared by every
+  * syntactic_continuation in the process, including isolates running on
+  * other threads. They are never modified after construction, and copying
+  * them only touches the reference count of std::shared_ptr (which is updated
+  * atomically), so reading them concurrently requires no synchronization.
+  *
+  * Never mutate these objects in place, or isolates will observe each other.
+  *========================================================================= */
   const object unit {nullptr};
 
   const object unbound {make<exception>("unbound")};
@@ -154,6 +178,61 @@ namespace meevax::kernel
     {"~",                         make<character>(u8"\u007E"                             )}, // tilde
     {"delete",                    make<character>(u8"\u007F", "delete"                   )},
   }; // characters
-} // namespace meevax::kernel
 
+  /* ==========================================================================
+  * Builtin Libraries (see builtin.hpp)
+  *========================================================================= */
+  #define BUILTIN(LIBRARY, NAME, ARITY, VARIADIC)                              \
+  {                                                                            \
+    "libmeevax-" #LIBRARY ".so " #NAME,                                        \
+    builtin { meevax::LIBRARY::NAME, ARITY, VARIADIC }                         \
+  }
+
+  const std::unordered_map<std::string, builtin> builtins
+  {
+  #ifdef MEEVAX_BUILTIN_LIBRARIES
+    BUILTIN(character, codepoint,    1, false),
+    BUILTIN(character, digit_value,  1, false),
+    BUILTIN(character, is_character, 1, false),
+
+    BUILTIN(equivalence, equals,     2, false),
+    BUILTIN(equivalence, equivalent, 2, false),
+
+    BUILTIN(experimental, display,        0, true),
+    BUILTIN(experimental, emergency_exit, 0, true),
+
+    BUILTIN(io, close_input_file,  1, false),
+    BUILTIN(io, close_output_file, 1, false),
+    BUILTIN(io, is_input_file,     1, false),
+    BUILTIN(io, is_output_file,    1, false),
+    BUILTIN(io, open_input_file,   1, false),
+    BUILTIN(io, open_output_file,  1, false),
 
+    BUILTIN(numerical, addition,       0, true),
+    BUILTIN(numerical, division,       1, true),
+    BUILTIN(numerical, greater,        2, true),
+    BUILTIN(numerical, greater_equal,  2, true),
+    BUILTIN(numerical, less,           2, true),
+    BUILTIN(numerical, less_equal,     2, true),
+    BUILTIN(numerical, multiplication, 0, true),
+    BUILTIN(numerical, real_,          1, false),
+    BUILTIN(numerical, subtraction,    1, true),
+
+    BUILTIN(pair, car,   1, false),
+    BUILTIN(pair, cdr,   1, false),
+    BUILTIN(pair, cons,  2, false),
+    BUILTIN(pair, pair_, 0, true),
+
+    BUILTIN(string, character_pair, 2, false),
+    BUILTIN(string, is_string,      1, false),
+
+    BUILTIN(symbol, is_symbol, 0, true),
+    BUILTIN(symbol, symbol,    0, true),
+
+    BUILTIN(vector, vector_of,        0, true),
+    BUILTIN(vector, vector_reference, 2, false),
+  #endif
+  }; // builtins
+
+  #undef BUILTIN
+} // namespace meevax::kernel
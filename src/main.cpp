@@ -1,10 +1,43 @@
 // #define THE_ONLY_SUBSET_OF_THE_EMPTY_SET_IS_ITSELF true
 
+#include <chrono>
+
 #include <meevax/kernel/syntactic_continuation.hpp>
+#include <meevax/posix/fork_server.hpp>
 
 int main(const int argc, char const* const* const argv) try
 {
-  meevax::kernel::syntactic_continuation program {meevax::kernel::layer<1>};
+  const auto start {std::chrono::steady_clock::now()};
+
+  meevax::kernel::syntactic_continuation program {meevax::kernel::layer<0>};
+
+  /****************************************************************************
+  * A standalone executable (see "--build-executable") runs its embedded
+  * program in the tree-shaken environment, and takes no options.
+  ****************************************************************************/
+  if (const auto image {meevax::posix::section("/proc/self/exe", meevax::posix::program_section)}; not std::empty(image)) try
+  {
+    std::istringstream port {image};
+
+    program.command_line = program.arguments(argv, argv + argc);
+
+    for (const auto& code : program.restore_program(port))
+    {
+      program.execute(code);
+    }
+
+    return boost::exit_success;
+  }
+  catch (const meevax::kernel::object& something)
+  {
+    std::cerr << something << std::endl;
+    return boost::exit_failure;
+  }
+  catch (const meevax::kernel::exception& exception)
+  {
+    std::cerr << exception << std::endl;
+    return boost::exit_failure;
+  }
 
   /****************************************************************************
   * The environment system includes a command line option parser. The parser is
@@ -13,6 +46,94 @@ int main(const int argc, char const* const* const argv) try
   ****************************************************************************/
   program.configure(argc, argv);
 
+  /****************************************************************************
+  * The client of the fork server boots nothing, and exits with the status of
+  * the evaluation on the server.
+  ****************************************************************************/
+  if (program.client_socket)
+  {
+    return meevax::posix::request(program.client_socket.as<meevax::kernel::path>().string());
+  }
+
+  /****************************************************************************
+  * Layer 1 is booted after the configuration, so that it can be restored from
+  * the heap image given by "--image" (see syntactic_continuation::boot).
+  ****************************************************************************/
+  const auto restored {program.boot()};
+
+  if (program.dump_file)
+  {
+    program.dump_image(program.dump_file.as<meevax::kernel::path>().string());
+    return boost::exit_success;
+  }
+
+  if (program.executable_file)
+  {
+    program.build_executable(program.executable_file.as<meevax::kernel::path>().string());
+    return boost::exit_success;
+  }
+
+  if (program.verbose == meevax::kernel::true_object)
+  {
+    std::cerr << "; boot\t\t; "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+              << " ms (from " << (restored ? "heap image" : "source") << ")" << std::endl;
+  }
+
+  /****************************************************************************
+  * The fork server forks this booted process for each request, and each child
+  * process evaluates the standard input of the client below.
+  ****************************************************************************/
+  if (program.server_socket)
+  {
+    meevax::posix::fork_server server {
+      program.server_socket.as<meevax::kernel::path>().string()
+    };
+
+    program.warm_up();
+
+    std::cerr << "; server\t; listening " << program.server_socket << std::endl;
+
+    server.serve();
+  }
+
+  /****************************************************************************
+  * The script given on the command line is evaluated without the prompt and
+  * the echo of the interaction. The standard output is not synchronized with
+  * C stdio and is flushed only by the script or at exit. An error ends the
+  * script with failure status.
+  ****************************************************************************/
+  if (program.script_file) try
+  {
+    std::ios_base::sync_with_stdio(false);
+
+    const auto script {program.script_file.as<meevax::kernel::path>().string()};
+
+    if (program.open(script); not program.is_open())
+    {
+      throw meevax::kernel::evaluation_error {"failed to open file ", std::quoted(script)};
+    }
+
+    for (auto expression {program.read()}; expression != meevax::kernel::characters.at("end-of-file"); expression = program.read())
+    {
+      program.execute(program.compile(expression));
+    }
+
+    return boost::exit_success;
+  }
+  catch (const meevax::kernel::object& something)
+  {
+    std::cout << std::flush;
+    std::cerr << something << std::endl;
+    return boost::exit_failure;
+  }
+  catch (const meevax::kernel::exception& exception)
+  {
+    std::cout << std::flush;
+    std::cerr << exception << std::endl;
+    return boost::exit_failure;
+  }
+
   for (program.open("/dev/stdin"); program.ready(); ) try
   {
     std::cout << "\n> " << std::flush;
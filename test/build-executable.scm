@@ -0,0 +1,31 @@
+; ------------------------------------------------------------------------------
+;   Standalone Executable
+;
+;   Built by "meevax --build-executable=FILE build-executable.scm", and run
+;   without the interpreter (see CMakeLists.txt). Exits with failure status if
+;   the macros are not expanded by the build.
+; ------------------------------------------------------------------------------
+
+(define swap!
+  (call/csc
+    (unhygienic-macro-transformer (swap! x y)
+      (list 'let (list (list 'value x))
+            (list 'set! x y)
+            (list 'set! y 'value)))))
+
+(define-syntax increment!
+  (environment (increment! x)
+   `(set! ,x (+ ,x 1))))
+
+(define a 1)
+
+(define b 2)
+
+(swap! a b)
+
+(increment! a)
+
+(if (equal? (cons a b) '(3 . 1))
+    (begin (display "test 1 expression passed (completed).")
+           (newline))
+    (emergency-exit 1))
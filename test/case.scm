@@ -0,0 +1,80 @@
+(define dispatch
+  (lambda (x)
+    (case x
+      ((s0) 0)
+      ((s1) 1)
+      ((s2) 2)
+      ((s3) 3)
+      ((s4) 4)
+      ((s5) 5)
+      ((s6) 6)
+      ((s7) 7)
+      ((s8) 8)
+      ((s9) 9)
+      ((s10) 10)
+      ((s11) 11)
+      ((s12) 12)
+      ((s13) 13)
+      ((s14) 14)
+      ((s15) 15)
+      ((s16) 16)
+      ((s17) 17)
+      ((s18) 18)
+      ((s19) 19)
+      ((s20) 20)
+      ((s21) 21)
+      ((s22) 22)
+      ((s23) 23)
+      ((s24) 24)
+      ((s25) 25)
+      ((s26) 26)
+      ((s27) 27)
+      ((s28) 28)
+      ((s29) 29)
+      ((s30) 30)
+      ((s31) 31)
+      ((s32) 32)
+      ((s33) 33)
+      ((s34) 34)
+      ((s35) 35)
+      ((s36) 36)
+      ((s37) 37)
+      ((s38) 38)
+      ((s39) 39)
+      ((s40) 40)
+      ((s41) 41)
+      ((s42) 42)
+      ((s43) 43)
+      ((s44) 44)
+      ((s45) 45)
+      ((s46) 46)
+      ((s47) 47)
+      ((s48) 48)
+      ((s49) 49)
+      ((s50) 50)
+      ((s51) 51)
+      ((s52) 52)
+      ((s53) 53)
+      ((s54) 54)
+      ((s55) 55)
+      ((s56) 56)
+      ((s57) 57)
+      ((s58) 58)
+      ((s59) 59)
+      ((s60) 60)
+      ((s61) 61)
+      ((s62) 62)
+      ((s63) 63)
+      (else -1))))
+
+(define keys
+  '(s0 s1 s2 s3 s4 s5 s6 s7 s8 s9 s10 s11 s12 s13 s14 s15 s16 s17 s18 s19 s20 s21 s22 s23 s24 s25 s26 s27 s28 s29 s30 s31 s32 s33 s34 s35 s36 s37 s38 s39 s40 s41 s42 s43 s44 s45 s46 s47 s48 s49 s50 s51 s52 s53 s54 s55 s56 s57 s58 s59 s60 s61 s62 s63))
+
+(define run
+  (lambda (n)
+    (let loop ((n n) (xs keys) (sum 0))
+      (cond ((= n 0) sum)
+            ((null? xs) (loop n keys sum))
+            (else (loop (- n 1) (cdr xs) (+ sum (dispatch (car xs)))))))))
+
+(run 100000)
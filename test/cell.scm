@@ -0,0 +1,153 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Mutable Bindings (cell) under Concurrent set! and Read
+;
+;   Benchmark: time meevax < cell.scm under "taskset -c 0-N" for N cores.
+; ------------------------------------------------------------------------------
+
+(define iota
+  (lambda (n)
+    (define iota-aux
+      (lambda (n result)
+        (if (< n 1) result
+            (iota-aux (- n 1) (cons (- n 1) result)))))
+    (iota-aux n '())))
+
+(define repeat
+  (lambda (n thunk)
+    (if (< 0 n)
+        (begin (thunk)
+               (repeat (- n 1) thunk)))))
+
+(define tasks (iota 16))
+
+(define iterations 2000)
+
+; Every reader must see one of the values written by some writer, never a torn
+; or reclaimed one.
+(define written?
+  (lambda (x)
+    (and (pair? x)
+         (< -1 (car x))
+         (< (car x) 16))))
+
+(define shared (list 0))
+
+(define global-stress
+  (lambda (n)
+    (let ((ok #t))
+      (repeat iterations
+        (lambda ()
+          (if (< n 8)
+              (set! shared (list n))
+              (if (not (written? shared))
+                  (set! ok #f)))))
+      ok)))
+
+(expect #t
+  (equal? (map (lambda (n) #t) tasks)
+          (parallel-map global-stress tasks)))
+
+(expect #t
+  (written? shared))
+
+(define make-box
+  (lambda (value)
+    (lambda xs
+      (if (pair? xs)
+          (set! value (car xs))
+          value))))
+
+(define box (make-box (list 0)))
+
+(define local-stress
+  (lambda (n)
+    (let ((ok #t))
+      (repeat iterations
+        (lambda ()
+          (if (< n 8)
+              (box (list n))
+              (if (not (written? (box)))
+                  (set! ok #f)))))
+      ok)))
+
+(expect #t
+  (equal? (map (lambda (n) #t) tasks)
+          (parallel-map local-stress tasks)))
+
+(expect #t
+  (written? (box)))
+
+; The assigned variable of variadic lambda.
+(define rest-box
+  (lambda xs
+    (lambda ()
+      (set! xs (cdr xs))
+      xs)))
+
+(expect (2 3)
+  ((rest-box 1 2 3)))
+
+(define counter
+  (lambda ()
+    (let ((count 0))
+      (lambda ()
+        (set! count (+ count 1))
+        count))))
+
+(define tick (counter))
+
+(tick)
+
+(expect 2
+  (tick))
+
+; The variable of a procedure inlined by the optimizer, assigned by a macro.
+(define increment!
+  (call/csc
+    (unhygienic-macro-transformer (increment! x)
+      (list 'set! x (list '+ x 1)))))
+
+(define successor
+  (lambda (n)
+    (increment! n)
+    n))
+
+(expect 6
+  (successor 5))
+
+; ------------------------------------------------------------------------------
+;   Assignment without Copy
+;
+;   Benchmark: a loop that repeatedly set!s a global counter.
+; ------------------------------------------------------------------------------
+
+(define table (list 1 2 3))
+
+(define alias #f)
+
+(set! alias table)
+
+(expect #t
+  (eq? alias table))
+
+(set! alias '())
+
+(expect ()
+  alias)
+
+(define count 0)
+
+(repeat 100000
+  (lambda ()
+    (set! count (+ count 1))))
+
+(expect 100000
+  count)
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
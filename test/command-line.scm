@@ -0,0 +1,23 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Script Mode
+;
+;   Run as "meevax command-line.scm a --b". The arguments after the script are
+;   not options of the interpreter, but of the script.
+; ------------------------------------------------------------------------------
+
+(expect ("command-line.scm" "a" "--b")
+  (command-line))
+
+(expect "a"
+  (cadr (command-line)))
+
+(expect 3
+  (length (command-line)))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,54 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Compiled-File Cache
+;
+;   The results must not change whether the file is compiled or loaded.
+;   Run without --compile-cache, which would evaluate the second load from the
+;   cache written by compile-file.
+; ------------------------------------------------------------------------------
+
+(define loaded 0)
+
+(define twice
+  (environment (twice x)
+   `(* 2 ,x)))
+
+(expect "../test/compile-file.ss.compiled"
+  (compile-file "../test/compile-file.ss"))
+
+(expect 1 loaded)
+
+(expect 0
+  (inverse 0))
+
+(expect 0.5
+  (inverse 2))
+
+(expect 10 r)
+
+(define inverse #f)
+
+; The cache is not used by load unless --compile-cache is given, so the macro
+; redefined by the loader is not hidden by the code compiled with the old one.
+(define twice
+  (environment (twice x)
+   `(* 3 ,x)))
+
+(load "../test/compile-file.ss")
+
+(expect 2 loaded)
+
+(expect 0
+  (inverse 0))
+
+(expect 0.25
+  (inverse 4))
+
+(expect 15 r)
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
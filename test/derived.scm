@@ -0,0 +1,236 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Derived Expressions as Special Forms
+;
+;   Benchmark: a loop which binds a variable by let and tests it by and/or.
+; ------------------------------------------------------------------------------
+
+; let
+(expect 3
+  (let ((x 1) (y 2))
+    (+ x y)))
+
+(expect 1
+  (let ((x 1))
+    (let ((x 2) (y x))
+      y)))
+
+(define make-counter
+  (lambda ()
+    (let ((count 0))
+      (lambda ()
+        (set! count (+ count 1))
+        count))))
+
+(define counter (make-counter))
+
+(counter)
+
+(expect 2
+  (counter))
+
+(expect 6
+  (let ()
+    (define x 2)
+    (define y 3)
+    (* x y)))
+
+(expect (1 . 2)
+  (cons (let ((x 1)) x)
+        (let ((x 2)) x)))
+
+; named let
+(expect 55
+  (let sum ((i 10) (result 0))
+    (if (< i 1)
+        result
+        (sum (- i 1) (+ result i)))))
+
+; let*
+(expect (1 2 3)
+  (let* ((x 1) (y (+ x 1)) (z (+ y 1)))
+    (list x y z)))
+
+(expect 0
+  (let* ()
+    0))
+
+; letrec
+(expect #t
+  (letrec ((even? (lambda (n) (if (= n 0) #t (odd? (- n 1)))))
+           (odd? (lambda (n) (if (= n 0) #f (even? (- n 1))))))
+    (even? 100)))
+
+; and
+(expect #t
+  (and))
+
+(expect 3
+  (and 1 2 3))
+
+(expect #f
+  (and 1 #f (car '())))
+
+; or
+(expect #f
+  (or))
+
+(expect 1
+  (or #f 1 (car '())))
+
+(expect #f
+  (or #f #f))
+
+; The value of or is not bound to any variable.
+(expect 5
+  (let ((result 5))
+    (or #f result)))
+
+; when and unless
+(expect 2
+  (when (< 1 2) 1 2))
+
+(expect 2
+  (unless (< 2 1) 1 2))
+
+; cond
+(expect 2
+  (cond ((< 2 1) 1)
+        ((< 1 2) 2)
+        (else 3)))
+
+(expect 3
+  (cond (#f 1)
+        (else 2 3)))
+
+(expect 4
+  (cond ((+ 1 3))
+        (else 5)))
+
+(expect 2
+  (cond ((cdr '(1 2)) => car)
+        (else 3)))
+
+(expect 3
+  (cond ((< 2 1) => car)
+        (else 3)))
+
+; case
+(expect composite
+  (case (* 2 3)
+    ((2 3 5 7) 'prime)
+    ((1 4 6 8 9) 'composite)))
+
+(expect consonant
+  (case (car '(c d))
+    ((a e i o u) 'vowel)
+    ((w y) 'semivowel)
+    (else 'consonant)))
+
+(expect c
+  (case (car '(c d))
+    ((a e i o u) 'vowel)
+    ((w y) 'semivowel)
+    (else => (lambda (x) x))))
+
+(expect 4
+  (case 3
+    ((1 2) 'low)
+    ((3 4) => (lambda (x) (+ x 1)))
+    (else 'high)))
+
+(expect space
+  (case #\space
+    ((#\a #\b) 'letter)
+    ((#\space #\tab) 'space)))
+
+(expect false
+  (case #f
+    ((#t) 'true)
+    ((#f) 'false)))
+
+(expect empty
+  (case '()
+    ((()) 'empty)
+    (else 'other)))
+
+(expect w
+  (case 'w
+    ((a e i o u) 'vowel)
+    ((w y))))
+
+; The first clause wins.
+(expect 1
+  (case 'x
+    ((x) 1)
+    ((x) 2)))
+
+(expect #t
+  (eq? (if #f #f)
+       (case 'z ((a) 1))))
+
+; Datums other than symbols, characters, booleans and numbers are compared by eqv?.
+(expect #f
+  (case (list 1)
+    (((1)) #t)
+    (else #f)))
+
+(expect 2
+  (let loop ((xs '(a b c d)) (n 0))
+    (if (null? xs) n
+        (loop (cdr xs)
+              (case (car xs)
+                ((a c) (+ n 1))
+                (else n))))))
+
+; quasiquote
+(expect (list 3 4)
+  `(list ,(+ 1 2) 4))
+
+(expect (1 2 3 4 5)
+  (let ((xs '(2 3 4)))
+    `(1 ,@xs 5)))
+
+(expect (1 . 2)
+  (let ((x 2))
+    `(1 . ,x)))
+
+(expect (a `(b ,(c 3)))
+  `(a `(b ,(c ,(+ 1 2)))))
+
+(expect #t
+  (let ((f (lambda () `(1 2 3))))
+    (eq? (f) (f))))
+
+(expect #f
+  (let ((f (lambda (x) `(1 ,x 3))))
+    (eq? (f 2) (f 2))))
+
+(define tail '(3))
+
+(expect #t
+  (eq? tail (cdr `(2 ,@tail))))
+
+; Re-entry into the body of let by a continuation
+(define reenter
+  (lambda ()
+    (let ((trace '())
+          (k #f))
+      (let ((x (call-with-current-continuation
+                 (lambda (continuation)
+                   (set! k continuation)
+                   1))))
+        (set! trace (cons x trace)))
+      (if (< (length trace) 3)
+          (k (+ (car trace) 1))
+          trace))))
+
+(expect (3 2 1)
+  (reenter))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,14 @@
+# Run SCRIPT with COMMAND, and check that it fails with the exit status RESULT
+# and an error message matching EXPECTS.
+execute_process(
+  COMMAND ${COMMAND} ${SCRIPT}
+  RESULT_VARIABLE result
+  OUTPUT_VARIABLE output
+  ERROR_VARIABLE output
+  )
+
+if(NOT result EQUAL RESULT)
+  message(FATAL_ERROR "${SCRIPT} exited with ${result} (expected ${RESULT})\n${output}")
+elseif(NOT output MATCHES "${EXPECTS}")
+  message(FATAL_ERROR "${SCRIPT} failed without \"${EXPECTS}\"\n${output}")
+endif()
@@ -0,0 +1,79 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Recycled Frames
+;
+;   Benchmark: time meevax < tarai.scm
+; ------------------------------------------------------------------------------
+
+(define tarai
+  (lambda (x y z)
+    (if (not (< y x)) y
+        (tarai (tarai (- x 1) y z)
+               (tarai (- y 1) z x)
+               (tarai (- z 1) x y)))))
+
+(expect 8
+  (tarai 8 4 0))
+
+; The frame of a leaf procedure must not be reused while a continuation
+; captured in its callee can still return into it.
+(define k #f)
+
+(define inner
+  (lambda ()
+    (call/cc
+      (lambda (continuation)
+        (set! k continuation)
+        0))))
+
+(define leaf
+  (lambda (x)
+    (+ x (inner))))
+
+(define results '())
+
+(define push!
+  (lambda (x)
+    (set! results (cons x results))))
+
+(push! (leaf 100))
+
+(tarai 6 3 0) ; reuses frames
+
+(if (< (length results) 2)
+    (k 5))
+
+(expect (105 100)
+  results)
+
+; Each exit of a body ending with a conditional hands the frame back.
+(define recycled
+  (lambda ()
+    (cdr (assq 'recycled (frame-statistics)))))
+
+(define before (recycled))
+
+(tarai 6 3 0)
+
+(expect #t
+  (< (+ before 100) (recycled)))
+
+; Closures keep their frames.
+(define make-adders
+  (lambda (n)
+    (list (lambda (x) (+ x n))
+          (lambda (x) (- x n)))))
+
+(define adders (make-adders 3))
+
+(make-adders 100)
+
+(expect (13 7)
+  (map (lambda (f) (f 10)) adders))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,2 @@
+; The exception of a future is rethrown to the thread touching it.
+(touch (future (1 2)))
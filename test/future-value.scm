@@ -0,0 +1,4 @@
+(if (equal? (touch (future (+ 1 2))) 3)
+    (begin (display "future passed (touched 3).")
+           (newline))
+    (emergency-exit 1))
@@ -0,0 +1,91 @@
+/* ============================================================================
+*
+* Isolates Test
+*
+*   Boots N independent syntactic_continuations on N threads, and makes each
+*   of them load "test.scm" concurrently. Every isolate has its own global
+*   environment, symbol table, configuration and virtual machine, so all of
+*   them must agree with the result of the sequential run.
+*
+*   Usage: meevax-isolates [N] (run in the "test" directory)
+*
+*========================================================================== */
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <meevax/kernel/syntactic_continuation.hpp>
+
+auto run()
+{
+  using namespace meevax::kernel;
+
+  syntactic_continuation isolate {layer<1>};
+
+  isolate.load("test.scm");
+
+  std::stringstream result {};
+  result << isolate.evaluate(isolate.intern("passed"));
+  return result.str();
+}
+
+int main(const int argc, char const* const* const argv) try
+{
+  const std::size_t size {
+    1 < argc ? std::stoul(argv[1])
+             : std::max(std::thread::hardware_concurrency(), 2u)
+  };
+
+  const auto expected {run()};
+
+  std::vector<std::string> results (size);
+  std::vector<std::exception_ptr> errors (size);
+
+  std::vector<std::thread> isolates {};
+
+  for (std::size_t index {0}; index < size; ++index)
+  {
+    isolates.emplace_back([&, index]()
+    {
+      try
+      {
+        results[index] = run();
+      }
+      catch (...)
+      {
+        errors[index] = std::current_exception();
+      }
+    });
+  }
+
+  for (auto&& each : isolates)
+  {
+    each.join();
+  }
+
+  for (std::size_t index {0}; index < size; ++index)
+  {
+    if (errors[index])
+    {
+      std::cerr << "; isolates\t; isolate " << index << " aborted with exception" << std::endl;
+      return boost::exit_test_failure;
+    }
+    else if (results[index] != expected)
+    {
+      std::cerr << "; isolates\t; isolate " << index << " passed " << results[index]
+                << " expression, but sequential run passed " << expected << std::endl;
+      return boost::exit_test_failure;
+    }
+  }
+
+  std::cerr << "; isolates\t; " << size << " isolates passed " << expected << " expression" << std::endl;
+
+  return boost::exit_success;
+}
+catch (...)
+{
+  std::cerr << "; isolates\t; sequential run aborted with exception" << std::endl;
+  return boost::exit_exception_failure;
+}
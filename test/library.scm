@@ -0,0 +1,108 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Libraries
+;
+;   (example stack) is loaded from "example/stack.sld" under the current
+;   directory, since it is not defined yet.
+; ------------------------------------------------------------------------------
+
+(import (example stack))
+
+(define stack (push (push (make-stack) 1) 2))
+
+(expect 2
+  (top stack))
+
+(expect 1
+  (top (pop stack)))
+
+(expect 2 pushed)
+
+(expect (5 4 3 2 1)
+  (push-all stack '(3 4 5)))
+
+(expect 5 pushed) ; the variable of the library, not a copy
+
+(expect #false
+  (empty? stack))
+
+(define-library (example counter)
+  (export next (rename counter-syntax counting))
+  (import (only (example stack) push pushed))
+  (begin
+
+    (define count 0)
+
+    (define next
+      (lambda ()
+        (set! count (+ count 1))
+        count))
+
+    (define-syntax counter-syntax
+      (call/csc
+        (unhygienic-macro-transformer (counter-syntax expression)
+          `(,list ,expression ,pushed))))))
+
+(import (prefix (example counter) counter-))
+
+(expect 1
+  (counter-next))
+
+(expect 2
+  (counter-next))
+
+(expect (a 5)
+  (counter-counting 'a))
+
+; A macro defined by call/csc is used by the following forms of the body.
+(define-library (example twice)
+  (export quadruple)
+  (begin
+
+    (define twice
+      (call/csc
+        (unhygienic-macro-transformer (twice x)
+          (list '* 2 x))))
+
+    (define quadruple
+      (lambda (x)
+        (twice (twice x))))))
+
+(import (example twice))
+
+(expect 12
+  (quadruple 3))
+
+; The global procedure inlined into the body by --optimize still refers to the
+; global variable, not to the variable of the library of the same name.
+(define scale 10)
+
+(define f
+  (lambda (x)
+    (* x scale)))
+
+(define-library (example scale)
+  (export g)
+  (begin
+
+    (define scale 1000)
+
+    (define g
+      (lambda ()
+        (f 2)))))
+
+(import (example scale))
+
+(expect 20
+  (g))
+
+(define pushed 0) ; shadows the import at toplevel
+
+(expect 0 pushed)
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
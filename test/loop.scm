@@ -0,0 +1,58 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Loops
+;
+;   Benchmark: a counting loop by named let (see "count").
+; ------------------------------------------------------------------------------
+
+(define count
+  (lambda (n)
+    (let rec ((i 0))
+      (if (< i n)
+          (rec (+ i 1))
+          i))))
+
+(expect 100000
+  (count 100000))
+
+(define sum
+  (lambda (n)
+    (define sum-aux
+      (lambda (i result)
+        (if (= i 0) result
+            (sum-aux (- i 1) (+ result i)))))
+    (sum-aux n 0)))
+
+(expect 5050
+  (sum 100))
+
+(expect (4 3 2 1 0)
+  (do ((i 0 (+ i 1))
+       (result '() (cons i result)))
+      ((= i 5) result)))
+
+; The frame of the loop is shared by the closures made in it.
+(expect (2 1 0)
+  (map (lambda (f) (f))
+       (let rec ((i 0)
+                 (result '()))
+         (if (< i 3)
+             (rec (+ i 1) (cons (lambda () i) result))
+             result))))
+
+; Not a loop because the variable is assigned again.
+(expect replaced
+  ((lambda (g)
+     (set! g (lambda (i)
+               (if (= i 0) 'done
+                   (begin (set! g (lambda (i) 'replaced))
+                          (g (- i 1))))))
+     (g 3))
+   #f))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,95 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Expansion Cache
+;
+;   Benchmark: (macroexpand-statistics) after evaluating the same macro use
+;   repeatedly.
+; ------------------------------------------------------------------------------
+
+(define statistic
+  (lambda (name)
+    (cdr (assq name (macroexpand-statistics)))))
+
+(define swap!
+  (call/csc
+    (unhygienic-macro-transformer (swap! x y)
+      (list 'let (list (list 'value x))
+            (list 'set! x y)
+            (list 'set! y 'value)))))
+
+(define a 1)
+
+(define b 2)
+
+(define hits (statistic 'hits))
+
+(define misses (statistic 'misses))
+
+(define swap-a-b '(swap! a b))
+
+(evaluate swap-a-b)
+
+(evaluate swap-a-b)
+
+(evaluate swap-a-b)
+
+(define hits (- (statistic 'hits) hits))
+
+(define misses (- (statistic 'misses) misses))
+
+(expect (2 . 1)
+  (cons a b))
+
+; Only the first expansion of the same (eq?) macro use, and of the macros its
+; expansion uses, is a miss.
+(expect #t
+  (< 1 hits))
+
+(expect #t
+  (< misses hits))
+
+; Structurally different uses are not confused.
+(evaluate '(swap! b a))
+
+(expect (1 . 2)
+  (cons a b))
+
+; Uses which are only equal? are expanded separately, since the transformer may
+; have side effects.
+(define n 0)
+
+(define stamp
+  (call/csc
+    (unhygienic-macro-transformer (stamp)
+      (set! n (+ n 1))
+      n)))
+
+(expect (1 2 3)
+  (list (stamp) (stamp) (stamp)))
+
+(define stamp-1 (evaluate '(stamp)))
+
+(define stamp-2 (evaluate '(stamp)))
+
+(expect (4 5)
+  (list stamp-1 stamp-2))
+
+(expect 5 n)
+
+; Redefinition of the macro is not hidden by the cache of the previous one.
+(define swap!
+  (call/csc
+    (unhygienic-macro-transformer (swap! x y)
+      (list 'set! x y))))
+
+(evaluate '(swap! a b))
+
+(expect (2 . 2)
+  (cons a b))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,34 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Native Procedures
+;
+;   Benchmark: calls of native procedures in a loop (see "churn"). Compare the
+;   time of the shared object build and of the BUILTIN_LIBRARIES build.
+; ------------------------------------------------------------------------------
+
+(define churn
+  (lambda (n)
+    (let rec ((i 0)
+              (xs '(0 . 0)))
+      (if (< i n)
+          (rec (+ i 1) (cons (car xs) (+ (cdr xs) 1)))
+          (cdr xs)))))
+
+(expect 200000
+  (churn 200000))
+
+(expect #t
+  (pair? (cons 1 2)))
+
+(expect (3 . 4)
+  (cons (+ 1 2) (- 6 2)))
+
+(expect #t
+  (eq? car car))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,156 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Optimization
+;
+;   Run with and without "--optimize". The results must not change.
+; ------------------------------------------------------------------------------
+
+; Constant folding
+(expect 10
+  (+ 1 (* 2 3) (- 5 2)))
+
+(expect #t
+  (< 1 2 3))
+
+(expect (1 . 2)
+  (cons 1 2))
+
+; Dead branch elimination
+(expect 1
+  (if (< 1 2) 1 (car '())))
+
+(expect 2
+  (if #f (car '()) 2))
+
+; Unused values of sequence
+(expect 3
+  (begin 1 '(2) (lambda () 4) 3))
+
+; Inlining
+(expect 6
+  ((lambda (x y) (* x y)) 2 3))
+
+(expect 12
+  ((lambda (x)
+     ((lambda (y) (* x y)) (+ x 1)))
+   3))
+
+(expect #t
+  (let ((x 1) (y 2))
+    (< x y)))
+
+; Not inlined because the formal is assigned.
+(expect 2
+  ((lambda (x) (set! x (+ x 1)) x) 1))
+
+(expect 2
+  ((lambda (x)
+     ((lambda () (set! x 2)))
+     x)
+   1))
+
+; Not inlined because the body has internal definitions.
+(expect 3
+  ((lambda (x)
+     (define y 2)
+     (+ x y))
+   1))
+
+; The closure captures the inlined formal.
+(define adder
+  ((lambda (n)
+     (lambda (x) (+ x n)))
+   10))
+
+(expect 15
+  (adder 5))
+
+; Inlining of global procedures
+(define twice
+  (lambda (x)
+    (* x 2)))
+
+(define twice-plus-one
+  (lambda (x)
+    (+ (twice x) 1)))
+
+(expect 7
+  (twice-plus-one 3))
+
+(define twice
+  (lambda (x)
+    (* x 3)))
+
+(expect 10
+  (twice-plus-one 3))
+
+(set! twice
+  (lambda (x)
+    (* x 4)))
+
+(expect 13
+  (twice-plus-one 3))
+
+; Not inlined because the global variable * in the body is shadowed.
+(expect 20
+  ((lambda (*)
+     (twice 5))
+   +))
+
+; Folded code falls back to the application after the procedure is assigned.
+(define plus +)
+
+(define less <)
+
+(define count 0)
+
+(define folded-application
+  (lambda ()
+    (+ 1 2)))
+
+(define folded-test
+  (lambda ()
+    (if (< 1 2) 'consequent 'alternate)))
+
+(define folded-operand
+  (lambda ()
+    ((lambda (x) x) (+ 1 2))))
+
+(define folded-command
+  (lambda ()
+    (+ 1 2)
+    count))
+
+(expect 3 (folded-application))
+
+(expect consequent (folded-test))
+
+(expect 3 (folded-operand))
+
+(expect 0 (folded-command))
+
+(set! + (lambda xs (set! count (plus count 1)) count))
+
+(set! < (lambda xs #f))
+
+(define application (folded-application))
+
+(define test (folded-test))
+
+(define operand (folded-operand))
+
+(define command (folded-command))
+
+(set! + plus)
+
+(set! < less)
+
+(expect (1 alternate 2 3)
+  (list application test operand command))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1,108 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Data Parallelism (parallel-map, parallel-for-each, parallel-reduce)
+;
+;   Benchmark: time meevax < parallel.scm under "taskset -c 0-N" for N cores.
+; ------------------------------------------------------------------------------
+
+(define fib
+  (lambda (n)
+    (if (< n 2) n
+        (+ (fib (- n 1))
+           (fib (- n 2))))))
+
+(define iota
+  (lambda (n)
+    (define iota-aux
+      (lambda (n result)
+        (if (< n 1) result
+            (iota-aux (- n 1) (cons (- n 1) result)))))
+    (iota-aux n '())))
+
+; Layer 1 procedures are compiled by their first reference, which may be of
+; workers. Both of the following have internal definitions, which must be
+; compiled as if the interaction referenced them first.
+(expect (#t #f #t)
+  (parallel-map (lambda (xs) (every odd? xs)) '((1 3) (1 2) (5))))
+
+(expect ("ac" "bd")
+  (parallel-map string-append '("a" "b") '("c" "d")))
+
+(expect ()
+  (parallel-map fib '()))
+
+(expect (0 1 1 2 3 5 8 13 21 34)
+  (parallel-map fib (iota 10)))
+
+(expect (5 7 9)
+  (parallel-map + '(1 2 3) '(4 5 6)))
+
+(expect (5 7)
+  (parallel-map + '(1 2 3) '(4 5)))
+
+(expect 4950
+  (parallel-reduce + 0 (iota 100)))
+
+(expect 0
+  (parallel-reduce + 0 '()))
+
+(define make-box
+  (lambda ()
+    (define value #f)
+    (lambda xs
+      (if (pair? xs)
+          (set! value (car xs))
+          value))))
+
+(define boxes (map (lambda (n) (make-box)) (iota 10)))
+
+(parallel-for-each (lambda (box n) (box (fib n))) boxes (iota 10))
+
+(expect (0 1 1 2 3 5 8 13 21 34)
+  (map (lambda (box) (box)) boxes))
+
+(define workload (make-list 64 16))
+
+(expect #t
+  (equal? (map fib workload)
+          (parallel-map fib workload)))
+
+; ------------------------------------------------------------------------------
+;   Futures (future, touch)
+; ------------------------------------------------------------------------------
+
+(define x (future (fib 20)))
+
+(define y (future (fib 19)))
+
+(expect 10946
+  (+ (touch x) (touch y)))
+
+(expect 6765
+  (touch x))
+
+(expect 42
+  (touch 42))
+
+(expect ()
+  (touch '()))
+
+(expect (0 1 1 2 3 5 8 13 21 34)
+  (map touch (map (lambda (n) (future (fib n))) (iota 10))))
+
+(expect 55
+  (touch (future (touch (future (fib 10))))))
+
+(expect 3
+  (touch (future (+ 1 2))))
+
+; Workers cannot call evaluate (see worker-*.scm), but the interaction can.
+(expect (1 2 3 4 5 6 7 8)
+  (map (lambda (x) (evaluate x)) '(1 2 3 4 5 6 7 8)))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
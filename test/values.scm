@@ -0,0 +1,103 @@
+(load "../test/expect.scm")
+
+; ------------------------------------------------------------------------------
+;   Multiple Values
+; ------------------------------------------------------------------------------
+
+(expect (1 . 2)
+  (call-with-values (lambda () (values 1 2)) cons))
+
+(expect 3
+  (call-with-values
+    (lambda () (values 1 2))
+    (lambda (a b) (+ a b))))
+
+(expect (5)
+  (call-with-values (lambda () 5) list))
+
+(expect ()
+  (call-with-values (lambda () (values)) list))
+
+(expect -1
+  (call-with-values * -))
+
+(expect (2 3)
+  (call-with-values
+    (lambda () (values 1 2 3))
+    (lambda (a . rest) rest)))
+
+; Returned from a procedure.
+(define two
+  (lambda ()
+    (values 1 2)))
+
+(expect (1 2)
+  (call-with-values two list))
+
+; First-class values and call-with-values.
+(expect (1 2)
+  (call-with-values (lambda () (apply values '(1 2))) list))
+
+(expect (3 4)
+  (apply call-with-values (list (lambda () (values 3 4)) list)))
+
+; Passed to a continuation.
+(expect (1 2)
+  (call-with-values
+    (lambda ()
+      (call-with-current-continuation
+        (lambda (k)
+          (k 1 2))))
+    list))
+
+; receive
+(expect (1 (2 3))
+  (receive (a . rest) (values 1 2 3)
+    (list a rest)))
+
+(expect 2
+  (receive (a) (values 1)
+    (set! a (+ a 1))
+    a))
+
+; let-values
+(expect (1 2 3)
+  (let-values (((a b) (values 1 2))
+               ((c) (values 3)))
+    (list a b c)))
+
+(expect outer
+  (let ((a 'outer))
+    (let-values (((a) (values 1))
+                 ((b) (values a)))
+      b)))
+
+(expect (1 (2))
+  (let-values (((a . b) (values 1 2)))
+    (list a b)))
+
+; let*-values
+(expect (x y x y)
+  (let ((a 'a) (b 'b) (x 'x) (y 'y))
+    (let*-values (((a b) (values x y))
+                  ((x y) (values a b)))
+      (list a b x y))))
+
+; In tail position of a loop.
+(define sum
+  (lambda (n)
+    (let loop ((i 0) (s 0))
+      (if (< i n)
+          (call-with-values
+            (lambda () (values (+ i 1) (+ s i)))
+            loop)
+          s))))
+
+(expect 4950
+  (sum 100))
+
+(begin (newline)
+       (display "test ")
+       (display passed)
+       (display " expression passed (completed).")
+       (newline))
@@ -0,0 +1 @@
+(touch (future (evaluate 1)))
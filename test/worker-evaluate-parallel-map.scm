@@ -0,0 +1 @@
+(parallel-map (lambda (x) (evaluate x)) '(1 2 3 4 5 6 7 8))
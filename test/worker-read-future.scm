@@ -0,0 +1 @@
+(touch (future (read)))